@@ -1,40 +1,197 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+template <template <typename> class Pool>
+class PoolFamily {
+  static constexpr uint64_t EntriesAmountMultiplier = 2;
+
+  template <typename T>
+  struct PoolTag {
+    static constexpr char value_ = 0;
+  };
+
+  struct Entry {
+    const void* tag_;
+    void* pool_;
+    void (*destroy_)(void* pool);
+  };
+
+ public:
+  PoolFamily(const PoolFamily& family) = delete;
+  PoolFamily(PoolFamily&& family) = delete;
+
+  PoolFamily& operator=(const PoolFamily& family) = delete;
+  PoolFamily& operator=(PoolFamily&& family) = delete;
+
+  PoolFamily();
+  ~PoolFamily();
+
+  template <typename T>
+  Pool<T>& Get();
+
+ private:
+  uint64_t entries_amount_;
+  uint64_t entries_allocated_;
+
+  Entry* entries_;
+};
+
 template <typename T, template <typename> class Pool>
 class PoolAllocator {
  public:
   using value_type = T;
 
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
   template <typename U>
   struct rebind {
     using other = PoolAllocator<U, Pool>;
   };
 
+  template <typename U, template <typename> class OtherPool>
+  friend class PoolAllocator;
+
  public:
-  template <typename... Args>
-  PoolAllocator(Args&&... args) : pool_(std::forward<Args>(args)...) {}
+  PoolAllocator();
+  explicit PoolAllocator(std::shared_ptr<PoolFamily<Pool>> family);
+
+  PoolAllocator(const PoolAllocator& allocator) = default;
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U, Pool>& allocator);
+
+  PoolAllocator& operator=(const PoolAllocator& allocator) = default;
+
+  ~PoolAllocator() = default;
 
   T* allocate(const uint64_t amount);
   void deallocate(T* ptr, const uint64_t amount);
-  T* reallocate(T* ptr, const uint64_t new_size);
+  T* reallocate(T* ptr, const uint64_t old_size, const uint64_t new_size);
+
+  Pool<T>& pool() const;
+  const std::shared_ptr<PoolFamily<Pool>>& family() const;
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U, Pool>& allocator) const;
+
+  template <typename U>
+  bool operator!=(const PoolAllocator<U, Pool>& allocator) const;
 
  private:
-  Pool<T> pool_;
+  std::shared_ptr<PoolFamily<Pool>> family_;
+  Pool<T>* pool_;
 };
 
+template <template <typename> class Pool>
+PoolFamily<Pool>::PoolFamily()
+    : entries_amount_(0), entries_allocated_(0), entries_(nullptr) {}
+
+template <template <typename> class Pool>
+PoolFamily<Pool>::~PoolFamily() {
+  if (entries_ == nullptr) {
+    return;
+  }
 
+  for (uint64_t entry_idx = 0; entry_idx < entries_amount_; entry_idx++) {
+    entries_[entry_idx].destroy_(entries_[entry_idx].pool_);
+  }
+
+  delete[] entries_;
+  entries_ = nullptr;
+}
+
+template <template <typename> class Pool>
+template <typename T>
+Pool<T>& PoolFamily<Pool>::Get() {
+  const void* tag = &PoolTag<T>::value_;
+
+  for (uint64_t entry_idx = 0; entry_idx < entries_amount_; entry_idx++) {
+    if (entries_[entry_idx].tag_ == tag) {
+      return *reinterpret_cast<Pool<T>*>(entries_[entry_idx].pool_);
+    }
+  }
+
+  if ((entries_amount_ + 1) > entries_allocated_) {
+    uint64_t new_entries_allocated =
+        (entries_allocated_ == 0) ? 1
+                                  : entries_allocated_ * EntriesAmountMultiplier;
+    Entry* new_entries = new Entry[new_entries_allocated]();
+
+    for (uint64_t entry_idx = 0; entry_idx < entries_amount_; entry_idx++) {
+      new_entries[entry_idx] = entries_[entry_idx];
+    }
+
+    delete[] entries_;
+    entries_ = new_entries;
+    entries_allocated_ = new_entries_allocated;
+  }
+
+  Pool<T>* pool = new Pool<T>();
+  entries_[entries_amount_++] = {
+      tag, pool, [](void* ptr) { delete reinterpret_cast<Pool<T>*>(ptr); }};
+
+  return *pool;
+}
+
+template <typename T, template <typename> class Pool>
+PoolAllocator<T, Pool>::PoolAllocator()
+    : family_(std::make_shared<PoolFamily<Pool>>()),
+      pool_(&family_->template Get<T>()) {}
+
+template <typename T, template <typename> class Pool>
+PoolAllocator<T, Pool>::PoolAllocator(
+    std::shared_ptr<PoolFamily<Pool>> family)
+    : family_(std::move(family)), pool_(&family_->template Get<T>()) {}
+
+template <typename T, template <typename> class Pool>
+template <typename U>
+PoolAllocator<T, Pool>::PoolAllocator(const PoolAllocator<U, Pool>& allocator)
+    : family_(allocator.family_), pool_(&family_->template Get<T>()) {}
 
 template <typename T, template <typename> class Pool>
 T* PoolAllocator<T, Pool>::allocate(const uint64_t amount) {
-  return pool_.GetFreePoolEntry(amount)->Allocate(amount);
+  return pool_->Allocate(amount);
 }
 
 template <typename T, template <typename> class Pool>
 void PoolAllocator<T, Pool>::deallocate(T* ptr, const uint64_t amount) {
-  pool_.FindEntryByPtr(ptr)->Deallocate(ptr, amount);
+  pool_->Deallocate(ptr, amount);
+}
+
+template <typename T, template <typename> class Pool>
+T* PoolAllocator<T, Pool>::reallocate(T* ptr, const uint64_t old_size,
+                                      const uint64_t new_size) {
+  return pool_->Reallocate(ptr, old_size, new_size);
+}
+
+template <typename T, template <typename> class Pool>
+Pool<T>& PoolAllocator<T, Pool>::pool() const {
+  return *pool_;
+}
+
+template <typename T, template <typename> class Pool>
+const std::shared_ptr<PoolFamily<Pool>>& PoolAllocator<T, Pool>::family()
+    const {
+  return family_;
+}
+
+template <typename T, template <typename> class Pool>
+template <typename U>
+bool PoolAllocator<T, Pool>::operator==(
+    const PoolAllocator<U, Pool>& allocator) const {
+  return family_ == allocator.family_;
 }
 
 template <typename T, template <typename> class Pool>
-T* PoolAllocator<T, Pool>::reallocate(T* ptr, const uint64_t new_size) {
-  return pool_.FindEntryByPtr(ptr)->Reallocate(ptr, new_size);
+template <typename U>
+bool PoolAllocator<T, Pool>::operator!=(
+    const PoolAllocator<U, Pool>& allocator) const {
+  return family_ != allocator.family_;
 }
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "memory.hpp"
+#include "utilities.hpp"
+
+// Vector for concurrent appends. Producers reserve indices with one atomic
+// add and construct their elements in place; storage is split into chunks of
+// BaseChunkSize << k elements which are installed once and never relocated.
+//
+// An element is visible to other threads once is_published() returns true
+// for it, and every index below published_size() is. Both use acquire
+// loads, so reading the element afterwards sees the fully constructed value.
+// Chunks are allocated by whichever producer needs them first, so Memory
+// must be usable from every producer thread. clear() and destruction are not
+// thread-safe.
+template <typename T, template <typename> class Memory = DefaultMemory>
+class ConcurrentVector {
+ public:
+  ConcurrentVector();
+
+  ConcurrentVector(const ConcurrentVector& vector) = delete;
+  ConcurrentVector(ConcurrentVector&& vector) = delete;
+
+  ConcurrentVector& operator=(const ConcurrentVector& vector) = delete;
+  ConcurrentVector& operator=(ConcurrentVector&& vector) = delete;
+
+  ~ConcurrentVector();
+
+  bool empty() const;
+
+  // Amount of reserved indices, some elements may still be under
+  // construction.
+  uint64_t size() const;
+
+  uint64_t published_size() const;
+  bool is_published(const uint64_t idx) const;
+
+  void reserve(const uint64_t new_capacity);
+
+  void clear();
+
+  // Returns the index of the first added element.
+  uint64_t push_back(T&& element);
+
+  template <typename... Args>
+  uint64_t emplace_back(Args&&... args);
+
+  uint64_t grow_by(const uint64_t amount, const T& elem = T());
+
+  // Only published indices may be read. operator[] doesn't check it, at()
+  // throws std::out_of_range for the rest.
+  T& at(const uint64_t idx);
+  const T& at(const uint64_t idx) const;
+
+  T& operator[](const uint64_t idx);
+  const T& operator[](const uint64_t idx) const;
+
+ private:
+  struct Chunk {
+    Chunk(const Chunk& chunk) = delete;
+    Chunk(Chunk&& chunk) = delete;
+
+    Chunk& operator=(const Chunk& chunk) = delete;
+    Chunk& operator=(Chunk&& chunk) = delete;
+
+    explicit Chunk(const uint64_t size);
+    ~Chunk();
+
+    Memory<T> memory_;
+    std::atomic<bool>* published_;
+  };
+
+  static constexpr uint64_t BaseChunkSize =
+      std::bit_ceil(std::max<uint64_t>(0x400 / sizeof(T), 1));
+  static constexpr uint64_t MaxChunksAmount =
+      64 - std::countr_zero(BaseChunkSize);
+
+  static uint64_t GetChunkIdx(const uint64_t idx);
+  static uint64_t GetChunkBegin(const uint64_t chunk_idx);
+  static uint64_t GetChunkSize(const uint64_t chunk_idx);
+
+  Chunk* GetChunk(const uint64_t chunk_idx);
+  void Publish(const uint64_t idx);
+
+  std::atomic<Chunk*> chunks_[MaxChunksAmount];
+
+  alignas(CacheLineSize) std::atomic<uint64_t> size_;
+  alignas(CacheLineSize) mutable std::atomic<uint64_t> published_size_;
+};
+
+template <typename T, template <typename> class Memory>
+ConcurrentVector<T, Memory>::Chunk::Chunk(const uint64_t size)
+    : memory_(size), published_(new std::atomic<bool>[size]()) {}
+
+template <typename T, template <typename> class Memory>
+ConcurrentVector<T, Memory>::Chunk::~Chunk() {
+  delete[] published_;
+  published_ = nullptr;
+}
+
+template <typename T, template <typename> class Memory>
+ConcurrentVector<T, Memory>::ConcurrentVector()
+    : chunks_(), size_(0), published_size_(0) {}
+
+template <typename T, template <typename> class Memory>
+ConcurrentVector<T, Memory>::~ConcurrentVector() {
+  clear();
+
+  for (uint64_t chunk_idx = MaxChunksAmount; chunk_idx > 0; chunk_idx--) {
+    delete chunks_[chunk_idx - 1].exchange(nullptr);
+  }
+}
+
+template <typename T, template <typename> class Memory>
+bool ConcurrentVector<T, Memory>::empty() const {
+  return (size() == 0);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t ConcurrentVector<T, Memory>::size() const {
+  return size_.load(std::memory_order_acquire);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t ConcurrentVector<T, Memory>::published_size() const {
+  uint64_t old_size = published_size_.load(std::memory_order_acquire);
+  uint64_t new_size = old_size;
+  uint64_t reserved_size = size();
+
+  while ((new_size < reserved_size) && is_published(new_size)) {
+    new_size++;
+  }
+
+  // The prefix only grows, so a failed exchange means another reader has
+  // already seen at least as much.
+  while ((old_size < new_size) &&
+         !published_size_.compare_exchange_weak(old_size, new_size,
+                                                std::memory_order_release,
+                                                std::memory_order_acquire)) {
+  }
+
+  return std::max(old_size, new_size);
+}
+
+template <typename T, template <typename> class Memory>
+bool ConcurrentVector<T, Memory>::is_published(const uint64_t idx) const {
+  uint64_t chunk_idx = GetChunkIdx(idx);
+  Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+
+  return (chunk != nullptr) &&
+         chunk->published_[idx - GetChunkBegin(chunk_idx)].load(
+             std::memory_order_acquire);
+}
+
+template <typename T, template <typename> class Memory>
+void ConcurrentVector<T, Memory>::reserve(const uint64_t new_capacity) {
+  if (new_capacity == 0) {
+    return;
+  }
+
+  for (uint64_t chunk_idx = 0; chunk_idx <= GetChunkIdx(new_capacity - 1);
+       chunk_idx++) {
+    GetChunk(chunk_idx);
+  }
+}
+
+template <typename T, template <typename> class Memory>
+void ConcurrentVector<T, Memory>::clear() {
+  uint64_t size = size_.exchange(0);
+
+  for (uint64_t idx = 0; idx < size; idx++) {
+    uint64_t chunk_idx = GetChunkIdx(idx);
+    Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_relaxed);
+
+    chunk->memory_.data()[idx - GetChunkBegin(chunk_idx)].~T();
+    chunk->published_[idx - GetChunkBegin(chunk_idx)].store(
+        false, std::memory_order_relaxed);
+  }
+
+  published_size_.store(0, std::memory_order_release);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t ConcurrentVector<T, Memory>::push_back(T&& element) {
+  return emplace_back(std::forward<T>(element));
+}
+
+template <typename T, template <typename> class Memory>
+template <typename... Args>
+uint64_t ConcurrentVector<T, Memory>::emplace_back(Args&&... args) {
+  uint64_t idx = size_.fetch_add(1, std::memory_order_relaxed);
+  uint64_t chunk_idx = GetChunkIdx(idx);
+
+  new (GetChunk(chunk_idx)->memory_.data() + (idx - GetChunkBegin(chunk_idx)))
+      T(std::forward<Args>(args)...);
+
+  Publish(idx);
+
+  return idx;
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t ConcurrentVector<T, Memory>::grow_by(const uint64_t amount,
+                                              const T& elem) {
+  uint64_t from = size_.fetch_add(amount, std::memory_order_relaxed);
+  uint64_t to = from + amount;
+
+  // Constructs chunk by chunk, each one is a contiguous range.
+  for (uint64_t idx = from; idx < to;) {
+    uint64_t chunk_idx = GetChunkIdx(idx);
+    uint64_t chunk_begin = GetChunkBegin(chunk_idx);
+    uint64_t chunk_to = std::min(to, chunk_begin + GetChunkSize(chunk_idx));
+
+    Construct(GetChunk(chunk_idx)->memory_.data(), idx - chunk_begin,
+              chunk_to - chunk_begin, elem);
+
+    for (; idx < chunk_to; idx++) {
+      Publish(idx);
+    }
+  }
+
+  return from;
+}
+
+template <typename T, template <typename> class Memory>
+T& ConcurrentVector<T, Memory>::at(const uint64_t idx) {
+  if (!is_published(idx)) {
+    throw std::out_of_range("ConcurrentVector index is not published");
+  }
+
+  return (*this)[idx];
+}
+
+template <typename T, template <typename> class Memory>
+const T& ConcurrentVector<T, Memory>::at(const uint64_t idx) const {
+  if (!is_published(idx)) {
+    throw std::out_of_range("ConcurrentVector index is not published");
+  }
+
+  return (*this)[idx];
+}
+
+template <typename T, template <typename> class Memory>
+T& ConcurrentVector<T, Memory>::operator[](const uint64_t idx) {
+  uint64_t chunk_idx = GetChunkIdx(idx);
+  Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+
+  assert((chunk != nullptr) && "Index is not reserved");
+
+  return chunk->memory_.data()[idx - GetChunkBegin(chunk_idx)];
+}
+
+template <typename T, template <typename> class Memory>
+const T& ConcurrentVector<T, Memory>::operator[](const uint64_t idx) const {
+  uint64_t chunk_idx = GetChunkIdx(idx);
+  Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+
+  assert((chunk != nullptr) && "Index is not reserved");
+
+  return chunk->memory_.data()[idx - GetChunkBegin(chunk_idx)];
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t ConcurrentVector<T, Memory>::GetChunkIdx(const uint64_t idx) {
+  return static_cast<uint64_t>(std::bit_width(idx / BaseChunkSize + 1)) - 1;
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t ConcurrentVector<T, Memory>::GetChunkBegin(const uint64_t chunk_idx) {
+  return BaseChunkSize * ((1ull << chunk_idx) - 1);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t ConcurrentVector<T, Memory>::GetChunkSize(const uint64_t chunk_idx) {
+  return BaseChunkSize << chunk_idx;
+}
+
+template <typename T, template <typename> class Memory>
+ConcurrentVector<T, Memory>::Chunk* ConcurrentVector<T, Memory>::GetChunk(
+    const uint64_t chunk_idx) {
+  assert(chunk_idx < MaxChunksAmount);
+
+  Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+
+  if (chunk != nullptr) {
+    return chunk;
+  }
+
+  // Racing producers may both allocate, the loser frees its chunk.
+  Chunk* new_chunk = new Chunk(GetChunkSize(chunk_idx));
+
+  if (chunks_[chunk_idx].compare_exchange_strong(chunk, new_chunk,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+    return new_chunk;
+  }
+
+  delete new_chunk;
+
+  return chunk;
+}
+
+template <typename T, template <typename> class Memory>
+void ConcurrentVector<T, Memory>::Publish(const uint64_t idx) {
+  uint64_t chunk_idx = GetChunkIdx(idx);
+
+  chunks_[chunk_idx]
+      .load(std::memory_order_relaxed)
+      ->published_[idx - GetChunkBegin(chunk_idx)]
+      .store(true, std::memory_order_release);
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "vector_view.hpp"
+
+template <typename T, template <typename> class Memory>
+class Vector;
+
+// Element-wise arithmetic, comparisons and math functions over numeric
+// vectors build a lazy expression tree instead of temporaries. The tree is
+// evaluated in one pass when it is assigned to a Vector, comparisons can be
+// assigned to Vector<bool> directly.
+class ExpressionTag {};
+
+template <typename E>
+concept LazyExpression = std::is_base_of_v<ExpressionTag, E>;
+
+template <typename T>
+concept ExpressionScalar = std::is_arithmetic_v<T>;
+
+template <typename T>
+struct IsNumericVector : std::false_type {};
+
+template <typename T, template <typename> class Memory>
+struct IsNumericVector<Vector<T, Memory>>
+    : std::bool_constant<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>> {
+};
+
+template <typename T>
+struct IsNumericVector<VectorView<T>>
+    : std::bool_constant<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>> {
+};
+
+template <typename T>
+concept ExpressionArray = LazyExpression<T> || IsNumericVector<T>::value;
+
+template <typename Lhs, typename Rhs>
+concept ExpressionOperands =
+    (ExpressionArray<Lhs> || ExpressionArray<Rhs>) &&
+    (ExpressionArray<Lhs> || ExpressionScalar<Lhs>) &&
+    (ExpressionArray<Rhs> || ExpressionScalar<Rhs>);
+
+// Size of a scalar, which matches arrays of any size.
+constexpr uint64_t AnyExpressionSize = UINT64_MAX;
+
+template <typename T>
+class TerminalExpression : public ExpressionTag {
+ public:
+  using value_type = T;
+
+  explicit TerminalExpression(const VectorView<T> view);
+
+  uint64_t size() const;
+  T operator[](const uint64_t idx) const;
+
+ private:
+  VectorView<T> view_;
+};
+
+template <typename T>
+class ScalarExpression : public ExpressionTag {
+ public:
+  using value_type = T;
+
+  explicit ScalarExpression(const T value);
+
+  uint64_t size() const;
+  T operator[](const uint64_t idx) const;
+
+ private:
+  T value_;
+};
+
+template <typename Op, typename Arg>
+class UnaryExpression : public ExpressionTag {
+ public:
+  using value_type = std::invoke_result_t<Op, typename Arg::value_type>;
+
+  UnaryExpression(const Op op, const Arg& arg);
+
+  uint64_t size() const;
+  value_type operator[](const uint64_t idx) const;
+
+ private:
+  [[no_unique_address]] Op op_;
+  Arg arg_;
+};
+
+template <typename Op, typename Lhs, typename Rhs>
+class BinaryExpression : public ExpressionTag {
+ public:
+  using value_type = std::invoke_result_t<Op, typename Lhs::value_type,
+                                          typename Rhs::value_type>;
+
+  BinaryExpression(const Op op, const Lhs& lhs, const Rhs& rhs);
+
+  uint64_t size() const;
+  value_type operator[](const uint64_t idx) const;
+
+ private:
+  [[no_unique_address]] Op op_;
+  Lhs lhs_;
+  Rhs rhs_;
+};
+
+template <typename T>
+TerminalExpression<T>::TerminalExpression(const VectorView<T> view)
+    : view_(view) {}
+
+template <typename T>
+uint64_t TerminalExpression<T>::size() const {
+  return view_.size();
+}
+
+template <typename T>
+T TerminalExpression<T>::operator[](const uint64_t idx) const {
+  return view_[idx];
+}
+
+template <typename T>
+ScalarExpression<T>::ScalarExpression(const T value) : value_(value) {}
+
+template <typename T>
+uint64_t ScalarExpression<T>::size() const {
+  return AnyExpressionSize;
+}
+
+template <typename T>
+T ScalarExpression<T>::operator[](const uint64_t) const {
+  return value_;
+}
+
+template <typename Op, typename Arg>
+UnaryExpression<Op, Arg>::UnaryExpression(const Op op, const Arg& arg)
+    : op_(op), arg_(arg) {}
+
+template <typename Op, typename Arg>
+uint64_t UnaryExpression<Op, Arg>::size() const {
+  return arg_.size();
+}
+
+template <typename Op, typename Arg>
+UnaryExpression<Op, Arg>::value_type UnaryExpression<Op, Arg>::operator[](
+    const uint64_t idx) const {
+  return op_(arg_[idx]);
+}
+
+template <typename Op, typename Lhs, typename Rhs>
+BinaryExpression<Op, Lhs, Rhs>::BinaryExpression(const Op op, const Lhs& lhs,
+                                                 const Rhs& rhs)
+    : op_(op), lhs_(lhs), rhs_(rhs) {
+  assert((lhs_.size() == rhs_.size()) || (lhs_.size() == AnyExpressionSize) ||
+         (rhs_.size() == AnyExpressionSize));
+}
+
+template <typename Op, typename Lhs, typename Rhs>
+uint64_t BinaryExpression<Op, Lhs, Rhs>::size() const {
+  return std::min(lhs_.size(), rhs_.size());
+}
+
+template <typename Op, typename Lhs, typename Rhs>
+BinaryExpression<Op, Lhs, Rhs>::value_type
+BinaryExpression<Op, Lhs, Rhs>::operator[](const uint64_t idx) const {
+  return op_(lhs_[idx], rhs_[idx]);
+}
+
+template <typename T>
+auto ToExpression(const T& operand) {
+  if constexpr (LazyExpression<T>) {
+    return operand;
+  } else if constexpr (ExpressionScalar<T>) {
+    return ScalarExpression<T>(operand);
+  } else {
+    using Value = std::remove_cvref_t<decltype(*operand.data())>;
+
+    return TerminalExpression<Value>(VectorView<Value>(operand));
+  }
+}
+
+template <typename Op, typename Arg>
+auto MakeUnaryExpression(const Op op, const Arg& arg) {
+  auto arg_expression = ToExpression(arg);
+
+  return UnaryExpression<Op, decltype(arg_expression)>(op, arg_expression);
+}
+
+template <typename Op, typename Lhs, typename Rhs>
+auto MakeBinaryExpression(const Op op, const Lhs& lhs, const Rhs& rhs) {
+  auto lhs_expression = ToExpression(lhs);
+  auto rhs_expression = ToExpression(rhs);
+
+  return BinaryExpression<Op, decltype(lhs_expression),
+                          decltype(rhs_expression)>(op, lhs_expression,
+                                                    rhs_expression);
+}
+
+struct AbsOp {
+  template <typename T>
+  T operator()(const T value) const {
+    return static_cast<T>(std::abs(value));
+  }
+};
+
+struct SqrtOp {
+  template <typename T>
+  auto operator()(const T value) const {
+    return std::sqrt(value);
+  }
+};
+
+struct ExpOp {
+  template <typename T>
+  auto operator()(const T value) const {
+    return std::exp(value);
+  }
+};
+
+struct LogOp {
+  template <typename T>
+  auto operator()(const T value) const {
+    return std::log(value);
+  }
+};
+
+struct MinOp {
+  template <typename Lhs, typename Rhs>
+  auto operator()(const Lhs lhs, const Rhs rhs) const {
+    using Common = std::common_type_t<Lhs, Rhs>;
+
+    return std::min(static_cast<Common>(lhs), static_cast<Common>(rhs));
+  }
+};
+
+struct MaxOp {
+  template <typename Lhs, typename Rhs>
+  auto operator()(const Lhs lhs, const Rhs rhs) const {
+    using Common = std::common_type_t<Lhs, Rhs>;
+
+    return std::max(static_cast<Common>(lhs), static_cast<Common>(rhs));
+  }
+};
+
+// Vectors enter a tree as views, so an expression must not outlive them or
+// be kept across anything that reallocates them: after auto e = a + b; a
+// push_back into a leaves e reading freed memory. Equality has no operator
+// form, as == and != are expected to return bool; Equal and NotEqual build
+// the element-wise comparison instead.
+template <ExpressionArray Arg>
+auto operator-(const Arg& arg) {
+  return MakeUnaryExpression(std::negate<>(), arg);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator+(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::plus<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator-(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::minus<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator*(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::multiplies<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator/(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::divides<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator<(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::less<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator<=(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::less_equal<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator>(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::greater<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto operator>=(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::greater_equal<>(), lhs, rhs);
+}
+
+template <ExpressionArray Arg>
+auto Abs(const Arg& arg) {
+  return MakeUnaryExpression(AbsOp(), arg);
+}
+
+template <ExpressionArray Arg>
+auto Sqrt(const Arg& arg) {
+  return MakeUnaryExpression(SqrtOp(), arg);
+}
+
+template <ExpressionArray Arg>
+auto Exp(const Arg& arg) {
+  return MakeUnaryExpression(ExpOp(), arg);
+}
+
+template <ExpressionArray Arg>
+auto Log(const Arg& arg) {
+  return MakeUnaryExpression(LogOp(), arg);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto Min(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(MinOp(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto Max(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(MaxOp(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto Equal(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::equal_to<>(), lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs>
+  requires ExpressionOperands<Lhs, Rhs>
+auto NotEqual(const Lhs& lhs, const Rhs& rhs) {
+  return MakeBinaryExpression(std::not_equal_to<>(), lhs, rhs);
+}
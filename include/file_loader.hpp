@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+
+#include "vector.hpp"
+
+constexpr uint64_t DefaultLoaderChunkSize = 0x4000000;
+
+// Streams a file descriptor in chunks of at most chunk_size bytes, so the
+// memory footprint stays bounded whatever the file size is. Regular files
+// are mapped one window at a time with the next window prefetched. Other
+// descriptors, or files that can't be mapped, are read by a background
+// thread into one of two buffers while the other one is being parsed.
+//
+// Chunks and records are valid until the next call. Use either NextChunk or
+// NextRecord on one loader, not both. Raw elements that need no parsing are
+// read faster by Vector::append_from_fd, without a staging copy.
+//
+// A window that fails to map midway switches the loader to reading. A read
+// error ends the data early and is reported by IsFailed.
+//
+// A mapped loader leaves the descriptor positioned right after the consumed
+// bytes when it is destroyed. A reading loader reads ahead, so the position
+// is unspecified afterwards.
+class FileLoader {
+ public:
+  explicit FileLoader(const int fd,
+                      const uint64_t chunk_size = DefaultLoaderChunkSize);
+
+  FileLoader(const FileLoader& loader) = delete;
+  FileLoader(FileLoader&& loader) = delete;
+
+  FileLoader& operator=(const FileLoader& loader) = delete;
+  FileLoader& operator=(FileLoader&& loader) = delete;
+
+  ~FileLoader();
+
+  bool IsMapped() const;
+  bool IsFailed() const;
+
+  // Returns an empty chunk at the end of the file.
+  std::span<const char> NextChunk();
+
+  // Stores the next record without its delimiter and returns false at the
+  // end of the file. Records crossing a chunk border are joined in a carry
+  // buffer, a trailing delimiter doesn't start an empty record.
+  bool NextRecord(const char delimiter, std::span<const char>& record);
+
+ private:
+  bool MapWindow();
+  void StartReader();
+
+  std::span<const char> NextMappedChunk();
+  std::span<const char> NextReadChunk();
+
+  void ReadBuffers();
+
+  int fd_;
+  uint64_t chunk_size_;
+
+  bool is_mapped_;
+  uint64_t file_end_;
+  uint64_t window_offset_;
+  uint64_t window_skip_;
+  char* window_;
+  uint64_t window_size_;
+  char* parsed_window_;
+  uint64_t parsed_window_size_;
+
+  char* buffers_[2];
+  uint64_t buffer_sizes_[2];
+  bool is_buffer_ready_[2];
+  uint64_t parsed_buffer_;
+  bool is_holding_buffer_;
+  bool is_read_finished_;
+  bool is_stopped_;
+  std::atomic<bool> is_failed_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread reader_;
+
+  std::span<const char> chunk_;
+  uint64_t chunk_pos_;
+  Vector<char> carry_;
+};
@@ -4,14 +4,31 @@
 
 #include "stack_pool.hpp"
 #include "page_pool.hpp"
+#include "slab_pool.hpp"
 #include "printf.hpp"
 
 #include "allocators.hpp"
+#include "memory_resources.hpp"
 
 #include "vector.hpp"
+#include "parallel_algorithms.hpp"
+#include "simd.hpp"
+#include "radix_sort.hpp"
+#include "soa_vector.hpp"
+#include "segmented_vector.hpp"
+#include "concurrent_vector.hpp"
+#include "ring_buffer.hpp"
+#include "string_vector.hpp"
+#include "file_loader.hpp"
 
 template <typename T>
 using StackAllocator = PoolAllocator<T, StackPool>;
 
 template <typename T>
 using PageAllocator = PoolAllocator<T, PagePool>;
+
+template <typename T>
+using HugePageAllocator = PoolAllocator<T, HugePagePool>;
+
+template <typename T>
+using SlabAllocator = PoolAllocator<T, SlabPool>;
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cassert>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
 #include "allocators.hpp"
 #include "stack_pool.hpp"
+#include "utilities.hpp"
 
 template <typename T>
 using StackAllocator = PoolAllocator<T, StackPool>;
@@ -9,11 +15,11 @@ using StackAllocator = PoolAllocator<T, StackPool>;
 template <typename T>
 class DefaultMemory {
  public:
-  DefaultMemory(const DefaultMemory& memory) = default;
-  DefaultMemory(DefaultMemory&& memory) = default;
+  DefaultMemory(const DefaultMemory& memory) = delete;
+  DefaultMemory(DefaultMemory&& memory);
 
-  DefaultMemory& operator=(const DefaultMemory& memory) = default;
-  DefaultMemory& operator=(DefaultMemory&& memory) = default;
+  DefaultMemory& operator=(const DefaultMemory& memory) = delete;
+  DefaultMemory& operator=(DefaultMemory&& memory);
 
   DefaultMemory(const uint64_t initial_size);
   ~DefaultMemory();
@@ -30,13 +36,14 @@ class DefaultMemory {
 template <typename T>
 class StackMemory {
  public:
-  StackMemory(const StackMemory& memory) = default;
-  StackMemory(StackMemory&& memory) = default;
+  StackMemory(const StackMemory& memory) = delete;
+  StackMemory(StackMemory&& memory);
 
-  StackMemory& operator=(const StackMemory& memory) = default;
-  StackMemory& operator=(StackMemory&& memory) = default;
+  StackMemory& operator=(const StackMemory& memory) = delete;
+  StackMemory& operator=(StackMemory&& memory);
 
-  StackMemory(const uint64_t initial_size);
+  StackMemory(const uint64_t initial_size,
+              StackArena* arena = &GetDefaultStackArena());
   ~StackMemory();
 
   void Realloc(const uint64_t, const uint64_t new_capacity);
@@ -44,9 +51,75 @@ class StackMemory {
   T* data();
   const T* data() const;
 
+  StackArena& arena() const;
+
  private:
-  StackAllocator<T> allocator_;
+  T* Allocate(const uint64_t amount);
+  void Deallocate(T* ptr, const uint64_t amount);
+
+  StackArena* arena_;
   T* data_;
+  uint64_t capacity_;
+};
+
+template <typename T>
+class PmrMemory {
+ public:
+  PmrMemory(const PmrMemory& memory) = delete;
+  PmrMemory(PmrMemory&& memory);
+
+  PmrMemory& operator=(const PmrMemory& memory) = delete;
+  PmrMemory& operator=(PmrMemory&& memory);
+
+  PmrMemory(const uint64_t initial_size,
+            std::pmr::memory_resource* resource =
+                std::pmr::get_default_resource());
+  ~PmrMemory();
+
+  void Realloc(const uint64_t, const uint64_t new_capacity);
+
+  T* data();
+  const T* data() const;
+
+  std::pmr::memory_resource* resource() const;
+
+ private:
+  std::pmr::memory_resource* resource_;
+  T* data_;
+  uint64_t capacity_;
+};
+
+// Inline storage for at most Capacity elements. It never touches the heap
+// and works in constant evaluation, so vectors built on it can be constexpr
+// data: Vector<int, FixedMemory<256>::Memory>.
+template <uint64_t Capacity>
+struct FixedMemory {
+  template <typename T>
+  class Memory {
+    static_assert(std::is_default_constructible_v<T> &&
+                      std::is_trivially_destructible_v<T>,
+                  "Fixed memory keeps its elements in a plain array");
+
+   public:
+    static constexpr uint64_t MaxCapacity = Capacity;
+
+    constexpr Memory(const Memory& memory) = default;
+    constexpr Memory(Memory&& memory) = default;
+
+    constexpr Memory& operator=(const Memory& memory) = default;
+    constexpr Memory& operator=(Memory&& memory) = default;
+
+    constexpr Memory(const uint64_t initial_size);
+    constexpr ~Memory() = default;
+
+    constexpr void Realloc(const uint64_t, const uint64_t new_capacity);
+
+    constexpr T* data();
+    constexpr const T* data() const;
+
+   private:
+    T data_[Capacity];
+  };
 };
 
 template <typename T>
@@ -56,6 +129,17 @@ DefaultMemory<T>::DefaultMemory(const uint64_t initial_size) : data_(nullptr) {
   }
 }
 
+template <typename T>
+DefaultMemory<T>::DefaultMemory(DefaultMemory&& memory)
+    : data_(std::exchange(memory.data_, nullptr)) {}
+
+template <typename T>
+DefaultMemory<T>& DefaultMemory<T>::operator=(DefaultMemory&& memory) {
+  std::swap(data_, memory.data_);
+
+  return *this;
+}
+
 template <typename T>
 DefaultMemory<T>::~DefaultMemory() {
   if (data_) {
@@ -67,7 +151,7 @@ DefaultMemory<T>::~DefaultMemory() {
 template <typename T>
 void DefaultMemory<T>::Realloc(const uint64_t size,
                                const uint64_t new_capacity) {
-  char* new_data = new char[new_capacity * sizeof(T)]();
+  char* new_data = new char[new_capacity * sizeof(T)];
   T* converted_new_data = reinterpret_cast<T*>(new_data);
 
   MoveConstruct(converted_new_data, 0, size, this->data());
@@ -88,27 +172,64 @@ const T* DefaultMemory<T>::data() const {
 }
 
 template <typename T>
-StackMemory<T>::StackMemory(const uint64_t initial_size)
-    : allocator_(), data_(nullptr) {
+StackMemory<T>::StackMemory(const uint64_t initial_size, StackArena* arena)
+    : arena_(arena), data_(nullptr), capacity_(initial_size) {
   if (initial_size) {
-    data_ = allocator_.allocate(initial_size);
+    data_ = Allocate(initial_size);
   }
 }
 
+template <typename T>
+StackMemory<T>::StackMemory(StackMemory&& memory)
+    : arena_(memory.arena_),
+      data_(std::exchange(memory.data_, nullptr)),
+      capacity_(std::exchange(memory.capacity_, 0)) {}
+
+template <typename T>
+StackMemory<T>& StackMemory<T>::operator=(StackMemory&& memory) {
+  std::swap(arena_, memory.arena_);
+  std::swap(data_, memory.data_);
+  std::swap(capacity_, memory.capacity_);
+
+  return *this;
+}
+
 template <typename T>
 StackMemory<T>::~StackMemory() {
+  if (data_ != nullptr) {
+    Deallocate(data_, capacity_);
+  }
+
   data_ = nullptr;
+  capacity_ = 0;
 }
 
 template <typename T>
-void StackMemory<T>::Realloc(const uint64_t, const uint64_t new_capacity) {
+void StackMemory<T>::Realloc(const uint64_t size,
+                             const uint64_t new_capacity) {
   if (data_ == nullptr) {
-    data_ = allocator_.allocate(new_capacity);
+    data_ = Allocate(new_capacity);
+    capacity_ = new_capacity;
 
     return;
   }
 
-  data_ = allocator_.reallocate(data(), new_capacity);
+  if (arena_->Extend(reinterpret_cast<char*>(data_), capacity_ * sizeof(T),
+                     new_capacity * sizeof(T))) {
+    capacity_ = new_capacity;
+
+    return;
+  }
+
+  T* new_data = Allocate(new_capacity);
+
+  MoveConstruct(new_data, 0, size, data_);
+  Destruct(data_, 0, size);
+
+  Deallocate(data_, capacity_);
+
+  data_ = new_data;
+  capacity_ = new_capacity;
 }
 
 template <typename T>
@@ -120,3 +241,112 @@ template <typename T>
 const T* StackMemory<T>::data() const {
   return data_;
 }
+
+template <typename T>
+StackArena& StackMemory<T>::arena() const {
+  return *arena_;
+}
+
+template <typename T>
+T* StackMemory<T>::Allocate(const uint64_t amount) {
+  return reinterpret_cast<T*>(arena_->Allocate(amount * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+void StackMemory<T>::Deallocate(T* ptr, const uint64_t amount) {
+  arena_->Deallocate(reinterpret_cast<char*>(ptr), amount * sizeof(T),
+                     alignof(T));
+}
+
+template <typename T>
+PmrMemory<T>::PmrMemory(const uint64_t initial_size,
+                        std::pmr::memory_resource* resource)
+    : resource_(resource), data_(nullptr), capacity_(initial_size) {
+  if (initial_size) {
+    data_ = static_cast<T*>(
+        resource_->allocate(initial_size * sizeof(T), alignof(T)));
+  }
+}
+
+template <typename T>
+PmrMemory<T>::PmrMemory(PmrMemory&& memory)
+    : resource_(memory.resource_),
+      data_(std::exchange(memory.data_, nullptr)),
+      capacity_(std::exchange(memory.capacity_, 0)) {}
+
+template <typename T>
+PmrMemory<T>& PmrMemory<T>::operator=(PmrMemory&& memory) {
+  std::swap(resource_, memory.resource_);
+  std::swap(data_, memory.data_);
+  std::swap(capacity_, memory.capacity_);
+
+  return *this;
+}
+
+template <typename T>
+PmrMemory<T>::~PmrMemory() {
+  if (data_ != nullptr) {
+    resource_->deallocate(data_, capacity_ * sizeof(T), alignof(T));
+  }
+
+  data_ = nullptr;
+  capacity_ = 0;
+}
+
+template <typename T>
+void PmrMemory<T>::Realloc(const uint64_t size, const uint64_t new_capacity) {
+  T* new_data = static_cast<T*>(
+      resource_->allocate(new_capacity * sizeof(T), alignof(T)));
+
+  if (data_ != nullptr) {
+    MoveConstruct(new_data, 0, size, data_);
+    Destruct(data_, 0, size);
+
+    resource_->deallocate(data_, capacity_ * sizeof(T), alignof(T));
+  }
+
+  data_ = new_data;
+  capacity_ = new_capacity;
+}
+
+template <typename T>
+T* PmrMemory<T>::data() {
+  return data_;
+}
+
+template <typename T>
+const T* PmrMemory<T>::data() const {
+  return data_;
+}
+
+template <typename T>
+std::pmr::memory_resource* PmrMemory<T>::resource() const {
+  return resource_;
+}
+
+template <uint64_t Capacity>
+template <typename T>
+constexpr FixedMemory<Capacity>::Memory<T>::Memory(
+    const uint64_t initial_size)
+    : data_() {
+  assert(initial_size <= Capacity);
+}
+
+template <uint64_t Capacity>
+template <typename T>
+constexpr void FixedMemory<Capacity>::Memory<T>::Realloc(
+    const uint64_t, const uint64_t new_capacity) {
+  assert(new_capacity <= Capacity);
+}
+
+template <uint64_t Capacity>
+template <typename T>
+constexpr T* FixedMemory<Capacity>::Memory<T>::data() {
+  return data_;
+}
+
+template <uint64_t Capacity>
+template <typename T>
+constexpr const T* FixedMemory<Capacity>::Memory<T>::data() const {
+  return data_;
+}
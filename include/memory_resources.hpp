@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory_resource>
+
+#include "page_pool.hpp"
+#include "slab_pool.hpp"
+#include "stack_pool.hpp"
+
+class StackResource : public std::pmr::memory_resource {
+ public:
+  StackResource(const StackResource& resource) = delete;
+  StackResource(StackResource&& resource) = delete;
+
+  StackResource& operator=(const StackResource& resource) = delete;
+  StackResource& operator=(StackResource&& resource) = delete;
+
+  StackResource();
+  ~StackResource() override = default;
+
+  StackPool<char>& pool();
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override;
+
+  StackPool<char> pool_;
+};
+
+class SlabResource : public std::pmr::memory_resource {
+ public:
+  SlabResource(const SlabResource& resource) = delete;
+  SlabResource(SlabResource&& resource) = delete;
+
+  SlabResource& operator=(const SlabResource& resource) = delete;
+  SlabResource& operator=(SlabResource&& resource) = delete;
+
+  SlabResource(std::pmr::memory_resource* upstream =
+                   std::pmr::new_delete_resource());
+  ~SlabResource() override = default;
+
+  SlabEngine& engine();
+
+ private:
+  static constexpr uint64_t MaxAlignment = 0x80;
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override;
+
+  SlabEngine engine_;
+  std::pmr::memory_resource* upstream_;
+};
+
+template <uint64_t BlockSize, uint64_t PageSize = 0x400>
+class PageResource : public std::pmr::memory_resource {
+ public:
+  PageResource(const PageResource& resource) = delete;
+  PageResource(PageResource&& resource) = delete;
+
+  PageResource& operator=(const PageResource& resource) = delete;
+  PageResource& operator=(PageResource&& resource) = delete;
+
+  PageResource(std::pmr::memory_resource* upstream =
+                   std::pmr::new_delete_resource());
+  ~PageResource() override = default;
+
+ private:
+  struct alignas(alignof(std::max_align_t)) Block {
+    char bytes_[BlockSize];
+  };
+
+  bool IsPooled(const size_t bytes, const size_t alignment) const;
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override;
+
+  PagePool<Block, PageSize> pool_;
+  std::pmr::memory_resource* upstream_;
+};
+
+template <uint64_t BlockSize, uint64_t PageSize>
+PageResource<BlockSize, PageSize>::PageResource(
+    std::pmr::memory_resource* upstream)
+    : pool_(), upstream_(upstream) {}
+
+template <uint64_t BlockSize, uint64_t PageSize>
+bool PageResource<BlockSize, PageSize>::IsPooled(
+    const size_t bytes, const size_t alignment) const {
+  return (bytes <= sizeof(Block)) && (alignment <= alignof(Block));
+}
+
+template <uint64_t BlockSize, uint64_t PageSize>
+void* PageResource<BlockSize, PageSize>::do_allocate(size_t bytes,
+                                                     size_t alignment) {
+  if (!IsPooled(bytes, alignment)) {
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  return pool_.Allocate(1);
+}
+
+template <uint64_t BlockSize, uint64_t PageSize>
+void PageResource<BlockSize, PageSize>::do_deallocate(void* ptr, size_t bytes,
+                                                      size_t alignment) {
+  if (!IsPooled(bytes, alignment)) {
+    upstream_->deallocate(ptr, bytes, alignment);
+
+    return;
+  }
+
+  pool_.Deallocate(reinterpret_cast<Block*>(ptr), 1);
+}
+
+template <uint64_t BlockSize, uint64_t PageSize>
+bool PageResource<BlockSize, PageSize>::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+enum class PageBacking {
+  Heap,
+  HugePages,
+};
+
+uint64_t GetOsPageSize();
+
+void ReleasePhysicalMemory(char* begin, char* end);
+
+// Reads until bytes are read or the end of the file, retrying short reads
+// and interrupts, and stores the amount of read bytes. Returns false on a
+// read error, with errno set and the bytes read before it stored.
+bool ReadFully(const int fd, char* data, const uint64_t bytes,
+               uint64_t& read_bytes);
+
+// Moves the position of fd back by bytes. Returns false for pipes and other
+// fds without a position.
+bool SeekBack(const int fd, const uint64_t bytes);
+
+class HugePageArena {
+ public:
+  static constexpr uint64_t HugePageSize = 0x200000;
+
+  HugePageArena(const HugePageArena& arena) = delete;
+  HugePageArena(HugePageArena&& arena) = delete;
+
+  HugePageArena& operator=(const HugePageArena& arena) = delete;
+  HugePageArena& operator=(HugePageArena&& arena) = delete;
+
+  HugePageArena(const uint64_t chunk_size);
+  ~HugePageArena();
+
+  char* AllocateChunk();
+  void DeallocateChunk(char* chunk);
+
+  uint64_t GetMappedBytes() const;
+
+ private:
+  struct Region {
+    char* begin_;
+    uint64_t size_;
+
+    Region* next_;
+  };
+
+  struct FreeChunk {
+    char* chunk_;
+
+    FreeChunk* next_;
+  };
+
+  static char* MapRegion(const uint64_t size);
+
+  uint64_t chunk_size_;
+  uint64_t region_size_;
+
+  Region* regions_;
+  char* region_ptr_;
+  char* region_end_;
+
+  FreeChunk* free_chunks_;
+};
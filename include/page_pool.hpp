@@ -1,42 +1,53 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <utility>
 
-template <typename T>
+#include "os_memory.hpp"
+#include "pool_stats.hpp"
+
+template <typename T, uint64_t PageSize = 0x400,
+          PageBacking Backing = PageBacking::Heap>
 class PagePool {
-  static constexpr uint64_t PageSize = 0x400;
   static constexpr uint64_t PageAmountMultiplier = 2;
   static constexpr uint64_t BitAmount = 64;
   static constexpr uint64_t BitFieldSize = PageSize / BitAmount;
+  static constexpr uint64_t WarmPagesAmount = 1;
+  static constexpr uint64_t PageBytes = PageSize * sizeof(T);
+
+  static_assert((PageSize != 0) && ((PageSize % BitAmount) == 0));
 
   struct Page {
     char* begin_;
     char* end_;
 
-    uint64_t bits_[BitFieldSize];
+    uint64_t* bits_;
     uint64_t free_amount_;
+    uint64_t free_bitfield_hint_;
 
     Page(const Page& page) = delete;
-    Page(Page&& page) = default;
+    Page(Page&& page) = delete;
 
     Page& operator=(const Page& page) = delete;
-    Page& operator=(Page&& page) = default;
+    Page& operator=(Page&& page) = delete;
 
-    Page(const uint64_t amount);
+    Page(char* memory);
     ~Page();
 
     T* Allocate(const uint64_t amount);
     void Deallocate(T* ptr, const uint64_t amount);
+
+    bool IsFree() const;
   };
 
  public:
   PagePool(const PagePool& pool) = delete;
-  PagePool(PagePool&& pool) = default;
+  PagePool(PagePool&& pool) = delete;
 
   PagePool& operator=(const PagePool& pool) = delete;
-  PagePool& operator=(PagePool&& pool) = default;
+  PagePool& operator=(PagePool&& pool) = delete;
 
   PagePool();
   ~PagePool();
@@ -44,101 +55,161 @@ class PagePool {
   Page* GetFreePoolEntry(const uint64_t size);
   Page* FindEntryByPtr(T* ptr, const uint64_t amount = 0);
 
+  T* Allocate(const uint64_t amount);
+  void Deallocate(T* ptr, const uint64_t amount);
+  T* Reallocate(T* ptr, const uint64_t old_size, const uint64_t new_size);
+
+  uint64_t GetReservedBytes() const;
+  PoolStats GetStats() const;
+
+  void Trim(const uint64_t target_bytes);
+  void SetHighWatermark(const uint64_t watermark_bytes);
+
  private:
+  Page* CreatePage();
+  void DestroyPage(Page* page);
+
+  HugePageArena* huge_page_arena_;
+
   uint64_t pages_amount_;
   uint64_t pages_allocated_;
 
   Page** pages_;
-};
 
-template <typename T>
-PagePool<T>::Page::Page(const uint64_t amount)
-    : begin_(new char[amount * sizeof(T)]()),
-      end_(begin_ + amount * sizeof(T)),
-      bits_(),
-      free_amount_(amount) {}
+  uint64_t high_watermark_;
+
+  [[no_unique_address]] PoolCounters counters_;
+};
 
 template <typename T>
-PagePool<T>::Page::~Page() {
-  if (begin_ != nullptr) {
-    delete[] begin_;
-    begin_ = nullptr;
+using HugePagePool =
+    PagePool<T,
+             std::max((HugePageArena::HugePageSize / sizeof(T)) & ~uint64_t(63),
+                      uint64_t(64)),
+             PageBacking::HugePages>;
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PagePool<T, PageSize, Backing>::Page::Page(char* memory)
+    : begin_(memory),
+      end_(begin_ + PageBytes),
+      bits_(new uint64_t[BitFieldSize]()),
+      free_amount_(PageSize),
+      free_bitfield_hint_(0) {}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PagePool<T, PageSize, Backing>::Page::~Page() {
+  if (bits_ != nullptr) {
+    delete[] bits_;
+    bits_ = nullptr;
   }
 
+  begin_ = nullptr;
   end_ = nullptr;
 }
 
-template <typename T>
-T* PagePool<T>::PagePool::Page::Allocate(const uint64_t amount) {
+template <typename T, uint64_t PageSize, PageBacking Backing>
+T* PagePool<T, PageSize, Backing>::PagePool::Page::Allocate(const uint64_t amount) {
   assert(amount == 1);
 
-  for (uint64_t bitfield_idx = 0; bitfield_idx < BitFieldSize; bitfield_idx++) {
-    int32_t clz = __builtin_clzl(~bits_[bitfield_idx]);
+  for (uint64_t bitfield_idx = free_bitfield_hint_; bitfield_idx < BitFieldSize;
+       bitfield_idx++) {
+    if (~bits_[bitfield_idx] == 0) {
+      continue;
+    }
+
+    uint64_t clz = static_cast<uint64_t>(__builtin_clzll(~bits_[bitfield_idx]));
 
-    if (clz != BitAmount) {
-      bits_[bitfield_idx] |= (1ull << ((BitAmount - 1) - clz));
-      free_amount_--;
+    bits_[bitfield_idx] |= (1ull << ((BitAmount - 1) - clz));
+    free_amount_--;
+    free_bitfield_hint_ = bitfield_idx;
 
-      return reinterpret_cast<T*>(
-          begin_ +
-          ((BitAmount * bitfield_idx + ((BitAmount - 1) - clz))) * sizeof(T));
-    }
+    return reinterpret_cast<T*>(
+        begin_ +
+        ((BitAmount * bitfield_idx + ((BitAmount - 1) - clz))) * sizeof(T));
   }
 
   assert(nullptr && "Can't find free space");
   return nullptr;
 }
 
-template <typename T>
-void PagePool<T>::PagePool::Page::Deallocate(T* ptr, const uint64_t amount) {
+template <typename T, uint64_t PageSize, PageBacking Backing>
+void PagePool<T, PageSize, Backing>::PagePool::Page::Deallocate(T* ptr, const uint64_t amount) {
   assert(amount == 1);
 
   char* char_ptr = reinterpret_cast<char*>(ptr);
 
-  uint64_t bitfield_idx = (char_ptr - begin_) / BitAmount;
-  uint64_t bitfield_shift = (char_ptr - begin_) % BitAmount;
+  uint64_t slot_idx = static_cast<uint64_t>(char_ptr - begin_) / sizeof(T);
+  uint64_t bitfield_idx = slot_idx / BitAmount;
+  uint64_t bitfield_shift = slot_idx % BitAmount;
 
-  assert(bits_[bitfield_idx] | (1ull << bitfield_shift));
+  assert(bits_[bitfield_idx] & (1ull << bitfield_shift));
 
   free_amount_++;
   bits_[bitfield_idx] &= ~(1ull << bitfield_shift);
+
+  if (bitfield_idx < free_bitfield_hint_) {
+    free_bitfield_hint_ = bitfield_idx;
+  }
 }
 
-template <typename T>
-PagePool<T>::PagePool()
-    : pages_amount_(1), pages_allocated_(1), pages_(new Page*[1]()) {
-  pages_[0] = new Page(PageSize);
+template <typename T, uint64_t PageSize, PageBacking Backing>
+bool PagePool<T, PageSize, Backing>::PagePool::Page::IsFree() const {
+  return free_amount_ == PageSize;
 }
 
-template <typename T>
-PagePool<T>::~PagePool() {
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PagePool<T, PageSize, Backing>::PagePool()
+    : huge_page_arena_(nullptr),
+      pages_amount_(1),
+      pages_allocated_(1),
+      pages_(new Page*[1]()),
+      high_watermark_(0),
+      counters_() {
+  if constexpr (Backing == PageBacking::HugePages) {
+    huge_page_arena_ = new HugePageArena(PageBytes);
+  }
+
+  pages_[0] = CreatePage();
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PagePool<T, PageSize, Backing>::~PagePool() {
   if (pages_ == nullptr) {
     return;
   }
 
   for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
     if (pages_[page_idx] != nullptr) {
-      delete pages_[page_idx];
+      DestroyPage(pages_[page_idx]);
       pages_[page_idx] = nullptr;
     }
   }
 
   delete[] pages_;
   pages_ = nullptr;
+
+  delete huge_page_arena_;
+  huge_page_arena_ = nullptr;
 }
 
-template <typename T>
-PagePool<T>::Page* PagePool<T>::GetFreePoolEntry(const uint64_t amount) {
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PagePool<T, PageSize, Backing>::Page* PagePool<T, PageSize, Backing>::GetFreePoolEntry(const uint64_t amount) {
   assert(amount <= PageSize);
 
   for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
     if (pages_[page_idx]->free_amount_ != 0) {
+      counters_.OnEntryScan(page_idx + 1);
+
       return pages_[page_idx];
     }
   }
 
+  counters_.OnEntryScan(pages_amount_);
+
   if ((pages_amount_ + 1) > pages_allocated_) {
-    Page** new_page_pool = new Page*[pages_amount_ * PageAmountMultiplier]();
+    uint64_t new_pages_allocated =
+        std::max(pages_allocated_ * PageAmountMultiplier, uint64_t(1));
+    Page** new_page_pool = new Page*[new_pages_allocated]();
 
     for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
       new_page_pool[page_idx] = pages_[page_idx];
@@ -146,17 +217,22 @@ PagePool<T>::Page* PagePool<T>::GetFreePoolEntry(const uint64_t amount) {
 
     delete[] pages_;
     pages_ = new_page_pool;
+    pages_allocated_ = new_pages_allocated;
   }
 
-  return pages_[++pages_amount_];
+  pages_[pages_amount_] = CreatePage();
+
+  return pages_[pages_amount_++];
 }
 
-template <typename T>
-PagePool<T>::Page* PagePool<T>::FindEntryByPtr(T* t_ptr, const uint64_t amount) {
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PagePool<T, PageSize, Backing>::Page* PagePool<T, PageSize, Backing>::FindEntryByPtr(T* t_ptr, const uint64_t amount) {
   char* ptr = reinterpret_cast<char*>(t_ptr);
 
   for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
     if ((ptr >= pages_[page_idx]->begin_) && ((ptr + amount * sizeof(T)) <= pages_[page_idx]->end_)) {
+      counters_.OnPtrScan(page_idx + 1);
+
       return pages_[page_idx];
     }
   }
@@ -164,3 +240,128 @@ PagePool<T>::Page* PagePool<T>::FindEntryByPtr(T* t_ptr, const uint64_t amount)
   assert(nullptr && "INVALID PTR");
   return nullptr;
 }
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+T* PagePool<T, PageSize, Backing>::Allocate(const uint64_t amount) {
+  counters_.OnAllocate(amount * sizeof(T));
+
+  return GetFreePoolEntry(amount)->Allocate(amount);
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+void PagePool<T, PageSize, Backing>::Deallocate(T* ptr, const uint64_t amount) {
+  Page* page = FindEntryByPtr(ptr, amount);
+  page->Deallocate(ptr, amount);
+
+  counters_.OnFree(amount * sizeof(T));
+
+  if (high_watermark_ && page->IsFree() &&
+      (GetReservedBytes() > high_watermark_)) {
+    Trim(high_watermark_);
+  }
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+T* PagePool<T, PageSize, Backing>::Reallocate(
+    T* ptr, [[maybe_unused]] const uint64_t old_size, const uint64_t new_size) {
+  assert((old_size <= 1) && (new_size == 1));
+
+  if (ptr == nullptr) {
+    return Allocate(new_size);
+  }
+
+  return ptr;
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+uint64_t PagePool<T, PageSize, Backing>::GetReservedBytes() const {
+  return pages_amount_ * PageBytes;
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PoolStats PagePool<T, PageSize, Backing>::GetStats() const {
+  PoolStats stats = {};
+  counters_.Fill(stats);
+
+  stats.entries_amount_ = pages_amount_;
+  stats.reserved_bytes_ = GetReservedBytes();
+
+  for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
+    if (!pages_[page_idx]->IsFree()) {
+      stats.fragmented_bytes_ += pages_[page_idx]->free_amount_ * sizeof(T);
+    }
+  }
+
+  return stats;
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+void PagePool<T, PageSize, Backing>::Trim(const uint64_t target_bytes) {
+  uint64_t free_pages = 0;
+  for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
+    free_pages += pages_[page_idx]->IsFree();
+  }
+
+  uint64_t reserved_bytes = GetReservedBytes();
+  uint64_t kept_pages = 0;
+
+  for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
+    Page* page = pages_[page_idx];
+
+    if (page->IsFree() && (free_pages > WarmPagesAmount) &&
+        (reserved_bytes > target_bytes)) {
+      DestroyPage(page);
+
+      free_pages--;
+      reserved_bytes -= PageBytes;
+
+      continue;
+    }
+
+    pages_[kept_pages++] = page;
+  }
+
+  for (uint64_t page_idx = kept_pages; page_idx < pages_amount_; page_idx++) {
+    pages_[page_idx] = nullptr;
+  }
+  pages_amount_ = kept_pages;
+
+  if (reserved_bytes <= target_bytes) {
+    return;
+  }
+
+  for (uint64_t page_idx = 0; page_idx < pages_amount_; page_idx++) {
+    if (pages_[page_idx]->IsFree()) {
+      ReleasePhysicalMemory(pages_[page_idx]->begin_, pages_[page_idx]->end_);
+    }
+  }
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+void PagePool<T, PageSize, Backing>::SetHighWatermark(const uint64_t watermark_bytes) {
+  high_watermark_ = watermark_bytes;
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+PagePool<T, PageSize, Backing>::Page* PagePool<T, PageSize, Backing>::CreatePage() {
+  char* memory = nullptr;
+
+  if constexpr (Backing == PageBacking::HugePages) {
+    memory = huge_page_arena_->AllocateChunk();
+  } else {
+    memory = new char[PageBytes]();
+  }
+
+  return new Page(memory);
+}
+
+template <typename T, uint64_t PageSize, PageBacking Backing>
+void PagePool<T, PageSize, Backing>::DestroyPage(Page* page) {
+  if constexpr (Backing == PageBacking::HugePages) {
+    huge_page_arena_->DeallocateChunk(page->begin_);
+  } else {
+    delete[] page->begin_;
+  }
+
+  delete page;
+}
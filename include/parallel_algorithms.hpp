@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+constexpr uint64_t ParallelGrainSize = 0x4000;
+
+template <typename Function>
+void ParallelForChunks(const uint64_t size, Function&& function) {
+  if (size <= ParallelGrainSize) {
+    function(0, size);
+
+    return;
+  }
+
+  ParallelFor(0, size, function);
+}
+
+template <typename Iterator, typename Function>
+void ParallelForEach(Iterator first, Iterator last, Function function) {
+  ParallelForChunks(static_cast<uint64_t>(last - first),
+                    [&](const uint64_t from, const uint64_t to) {
+                      std::for_each(first + static_cast<std::ptrdiff_t>(from),
+                                    first + static_cast<std::ptrdiff_t>(to),
+                                    function);
+                    });
+}
+
+template <typename Iterator, typename OutputIterator, typename Operation>
+OutputIterator ParallelTransform(Iterator first, Iterator last,
+                                 OutputIterator d_first, Operation operation) {
+  ParallelForChunks(
+      static_cast<uint64_t>(last - first),
+      [&](const uint64_t from, const uint64_t to) {
+        std::transform(first + static_cast<std::ptrdiff_t>(from),
+                       first + static_cast<std::ptrdiff_t>(to),
+                       d_first + static_cast<std::ptrdiff_t>(from), operation);
+      });
+
+  return d_first + (last - first);
+}
+
+template <typename Iterator, typename T, typename Operation = std::plus<>>
+T ParallelReduce(Iterator first, Iterator last, T init,
+                 Operation operation = Operation()) {
+  uint64_t size = static_cast<uint64_t>(last - first);
+  uint64_t chunks_amount = std::min(
+      ThreadPool::GetDefault().GetThreadsAmount() * ParallelTasksPerThread,
+      (size + ParallelGrainSize - 1) / ParallelGrainSize);
+
+  if (chunks_amount < 2) {
+    return std::accumulate(first, last, std::move(init), operation);
+  }
+
+  Vector<T> partials;
+  partials.resize(chunks_amount, T());
+
+  ParallelFor(0, chunks_amount, [&](const uint64_t from, const uint64_t to) {
+    for (uint64_t chunk_idx = from; chunk_idx < to; chunk_idx++) {
+      Iterator chunk_first =
+          first + static_cast<std::ptrdiff_t>(size * chunk_idx / chunks_amount);
+      Iterator chunk_last = first + static_cast<std::ptrdiff_t>(
+                                        size * (chunk_idx + 1) / chunks_amount);
+
+      T partial = *chunk_first;
+
+      for (++chunk_first; chunk_first != chunk_last; ++chunk_first) {
+        partial = operation(std::move(partial), *chunk_first);
+      }
+
+      partials[chunk_idx] = std::move(partial);
+    }
+  });
+
+  for (uint64_t chunk_idx = 0; chunk_idx < chunks_amount; chunk_idx++) {
+    init = operation(std::move(init), partials[chunk_idx]);
+  }
+
+  return init;
+}
+
+// Two passes: chunk totals in parallel, a serial prefix over the totals, then
+// every chunk rescans itself starting from its offset.
+template <typename Iterator, typename OutputIterator,
+          typename Operation = std::plus<>>
+OutputIterator ParallelInclusiveScan(Iterator first, Iterator last,
+                                     OutputIterator d_first,
+                                     Operation operation = Operation()) {
+  using T = typename std::iterator_traits<Iterator>::value_type;
+
+  uint64_t size = static_cast<uint64_t>(last - first);
+  uint64_t chunks_amount = std::min(
+      ThreadPool::GetDefault().GetThreadsAmount() * ParallelTasksPerThread,
+      (size + ParallelGrainSize - 1) / ParallelGrainSize);
+
+  if (chunks_amount < 2) {
+    return std::inclusive_scan(first, last, d_first, operation);
+  }
+
+  auto get_chunk = [&](const uint64_t chunk_idx) {
+    return std::make_pair(
+        static_cast<std::ptrdiff_t>(size * chunk_idx / chunks_amount),
+        static_cast<std::ptrdiff_t>(size * (chunk_idx + 1) / chunks_amount));
+  };
+
+  Vector<T> totals;
+  totals.resize(chunks_amount, T());
+
+  ParallelFor(0, chunks_amount - 1,
+              [&](const uint64_t from, const uint64_t to) {
+                for (uint64_t chunk_idx = from; chunk_idx < to; chunk_idx++) {
+                  auto [chunk_from, chunk_to] = get_chunk(chunk_idx);
+
+                  T total = first[chunk_from];
+
+                  for (std::ptrdiff_t idx = chunk_from + 1; idx < chunk_to;
+                       idx++) {
+                    total = operation(std::move(total), first[idx]);
+                  }
+
+                  totals[chunk_idx] = std::move(total);
+                }
+              });
+
+  for (uint64_t chunk_idx = 1; chunk_idx < chunks_amount - 1; chunk_idx++) {
+    totals[chunk_idx] = operation(totals[chunk_idx - 1], totals[chunk_idx]);
+  }
+
+  ParallelFor(0, chunks_amount, [&](const uint64_t from, const uint64_t to) {
+    for (uint64_t chunk_idx = from; chunk_idx < to; chunk_idx++) {
+      auto [chunk_from, chunk_to] = get_chunk(chunk_idx);
+
+      if (chunk_idx == 0) {
+        std::inclusive_scan(first + chunk_from, first + chunk_to,
+                            d_first + chunk_from, operation);
+      } else {
+        std::inclusive_scan(first + chunk_from, first + chunk_to,
+                            d_first + chunk_from, operation,
+                            totals[chunk_idx - 1]);
+      }
+    }
+  });
+
+  return d_first + (last - first);
+}
+
+template <typename Iterator, typename OutputIterator, typename Compare>
+void ParallelMerge(Iterator first1, Iterator last1, Iterator first2,
+                   Iterator last2, OutputIterator d_first, Compare& compare) {
+  std::ptrdiff_t size1 = last1 - first1;
+  std::ptrdiff_t size2 = last2 - first2;
+
+  if (static_cast<uint64_t>(size1 + size2) <= ParallelGrainSize) {
+    std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+               std::make_move_iterator(first2), std::make_move_iterator(last2),
+               d_first, compare);
+
+    return;
+  }
+
+  if (size1 < size2) {
+    // Keep the split stable: equal elements of the first range go first.
+    Iterator mid2 = first2 + size2 / 2;
+    Iterator mid1 = std::upper_bound(first1, last1, *mid2, compare);
+    OutputIterator d_mid = d_first + ((mid1 - first1) + (mid2 - first2));
+
+    TaskGroup group;
+    group.Spawn([&] {
+      ParallelMerge(first1, mid1, first2, mid2, d_first, compare);
+    });
+    ParallelMerge(mid1, last1, mid2, last2, d_mid, compare);
+    group.Wait();
+  } else {
+    Iterator mid1 = first1 + size1 / 2;
+    Iterator mid2 = std::lower_bound(first2, last2, *mid1, compare);
+    OutputIterator d_mid = d_first + ((mid1 - first1) + (mid2 - first2));
+
+    TaskGroup group;
+    group.Spawn([&] {
+      ParallelMerge(first1, mid1, first2, mid2, d_first, compare);
+    });
+    ParallelMerge(mid1, last1, mid2, last2, d_mid, compare);
+    group.Wait();
+  }
+}
+
+// Sorts [first, last) and leaves the result in [first, last) when to_buffer
+// is false, or in the matching range of buffer when it is true.
+template <typename Iterator, typename BufferIterator, typename Compare>
+void ParallelMergeSort(Iterator first, Iterator last, BufferIterator buffer,
+                       const bool to_buffer, Compare& compare) {
+  std::ptrdiff_t size = last - first;
+
+  if (static_cast<uint64_t>(size) <= ParallelGrainSize) {
+    std::sort(first, last, compare);
+
+    if (to_buffer) {
+      std::move(first, last, buffer);
+    }
+
+    return;
+  }
+
+  Iterator mid = first + size / 2;
+  BufferIterator buffer_mid = buffer + size / 2;
+  BufferIterator buffer_last = buffer + size;
+
+  {
+    TaskGroup group;
+    group.Spawn([&] {
+      ParallelMergeSort(first, mid, buffer, !to_buffer, compare);
+    });
+    ParallelMergeSort(mid, last, buffer_mid, !to_buffer, compare);
+    group.Wait();
+  }
+
+  if (to_buffer) {
+    ParallelMerge(first, mid, mid, last, buffer, compare);
+  } else {
+    ParallelMerge(buffer, buffer_mid, buffer_mid, buffer_last, first, compare);
+  }
+}
+
+// Kept apart from ParallelSort, which has to stay usable in constant
+// evaluation and so can't own a heap buffer.
+template <typename Iterator, typename Compare>
+void ParallelBufferedSort(Iterator first, Iterator last, Compare& compare) {
+  using T = typename std::iterator_traits<Iterator>::value_type;
+
+  Vector<T> buffer;
+  buffer.resize(static_cast<uint64_t>(last - first), T());
+
+  ParallelMergeSort(first, last, buffer.begin(), false, compare);
+}
+
+template <typename Iterator, typename Compare = std::less<>>
+constexpr void ParallelSort(Iterator first, Iterator last,
+                            Compare compare = Compare()) {
+  uint64_t size = static_cast<uint64_t>(last - first);
+
+  if (std::is_constant_evaluated() || (size <= ParallelGrainSize) ||
+      (ThreadPool::GetDefault().GetThreadsAmount() == 1)) {
+    std::sort(first, last, compare);
+
+    return;
+  }
+
+  ParallelBufferedSort(first, last, compare);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+struct PoolStats {
+  uint64_t allocations_;
+  uint64_t frees_;
+  uint64_t reallocations_;
+
+  uint64_t bytes_in_use_;
+  uint64_t high_watermark_bytes_;
+
+  uint64_t entries_amount_;
+  uint64_t reserved_bytes_;
+  uint64_t fragmented_bytes_;
+
+  uint64_t entry_scans_;
+  uint64_t max_entry_scan_;
+  uint64_t ptr_scans_;
+  uint64_t max_ptr_scan_;
+
+  void Dump(std::ostream& stream, const char* prefix = "pool") const;
+};
+
+#ifdef POOL_STATISTICS
+
+class PoolCounters {
+ public:
+  void OnAllocate(const uint64_t bytes) {
+    allocations_++;
+    bytes_in_use_ += bytes;
+
+    if (bytes_in_use_ > high_watermark_bytes_) {
+      high_watermark_bytes_ = bytes_in_use_;
+    }
+  }
+
+  void OnFree(const uint64_t bytes) {
+    frees_++;
+    bytes_in_use_ -= bytes;
+  }
+
+  // Counts every block released by a rewind as freed.
+  void OnRewind(const uint64_t amount, const uint64_t bytes) {
+    frees_ += amount;
+    bytes_in_use_ -= bytes;
+  }
+
+  void OnReallocate(const uint64_t old_bytes, const uint64_t new_bytes) {
+    reallocations_++;
+    bytes_in_use_ = bytes_in_use_ - old_bytes + new_bytes;
+
+    if (bytes_in_use_ > high_watermark_bytes_) {
+      high_watermark_bytes_ = bytes_in_use_;
+    }
+  }
+
+  void OnEntryScan(const uint64_t steps) {
+    entry_scans_ += steps;
+
+    if (steps > max_entry_scan_) {
+      max_entry_scan_ = steps;
+    }
+  }
+
+  void OnPtrScan(const uint64_t steps) {
+    ptr_scans_ += steps;
+
+    if (steps > max_ptr_scan_) {
+      max_ptr_scan_ = steps;
+    }
+  }
+
+  void Fill(PoolStats& stats) const {
+    stats.allocations_ = allocations_;
+    stats.frees_ = frees_;
+    stats.reallocations_ = reallocations_;
+    stats.bytes_in_use_ = bytes_in_use_;
+    stats.high_watermark_bytes_ = high_watermark_bytes_;
+    stats.entry_scans_ = entry_scans_;
+    stats.max_entry_scan_ = max_entry_scan_;
+    stats.ptr_scans_ = ptr_scans_;
+    stats.max_ptr_scan_ = max_ptr_scan_;
+  }
+
+ private:
+  uint64_t allocations_ = 0;
+  uint64_t frees_ = 0;
+  uint64_t reallocations_ = 0;
+
+  uint64_t bytes_in_use_ = 0;
+  uint64_t high_watermark_bytes_ = 0;
+
+  uint64_t entry_scans_ = 0;
+  uint64_t max_entry_scan_ = 0;
+  uint64_t ptr_scans_ = 0;
+  uint64_t max_ptr_scan_ = 0;
+};
+
+#else
+
+class PoolCounters {
+ public:
+  void OnAllocate(const uint64_t) {}
+  void OnFree(const uint64_t) {}
+  void OnRewind(const uint64_t, const uint64_t) {}
+  void OnReallocate(const uint64_t, const uint64_t) {}
+  void OnEntryScan(const uint64_t) {}
+  void OnPtrScan(const uint64_t) {}
+
+  void Fill(PoolStats&) const {}
+};
+
+#endif
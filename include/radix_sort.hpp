@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "vector.hpp"
+
+constexpr uint64_t RadixDigitBits = 8;
+constexpr uint64_t RadixBucketsAmount = 1ull << RadixDigitBits;
+constexpr uint64_t RadixSmallSortSize = 64;
+
+// Maps an arithmetic key to an unsigned integer with the same ordering.
+template <typename Key>
+auto ToRadixBits(const Key key) {
+  static_assert(std::is_arithmetic_v<Key>, "Radix keys must be arithmetic");
+
+  if constexpr (std::is_floating_point_v<Key>) {
+    using Bits = std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>;
+    constexpr Bits SignBit = Bits(1) << (sizeof(Bits) * 8 - 1);
+
+    Bits bits = 0;
+    std::memcpy(&bits, &key, sizeof(Key));
+
+    // -0.0 compares equal to +0.0, so both keep their relative order.
+    if (bits == SignBit) {
+      bits = 0;
+    }
+
+    return static_cast<Bits>((bits & SignBit) ? ~bits : (bits | SignBit));
+  } else if constexpr (std::is_signed_v<Key>) {
+    using Bits = std::make_unsigned_t<Key>;
+    constexpr Bits SignBit = Bits(1) << (sizeof(Bits) * 8 - 1);
+
+    return static_cast<Bits>(static_cast<Bits>(key) ^ SignBit);
+  } else {
+    return key;
+  }
+}
+
+// Scratch memory comes from the same policy, and from the same arena or
+// resource when the policy exposes one.
+template <typename U, typename T, template <typename> class Memory>
+Memory<U> MakeScratchMemory(const Vector<T, Memory>& vector,
+                            const uint64_t size) {
+  if constexpr (requires { vector.resource(); }) {
+    return Memory<U>(size, vector.resource());
+  } else if constexpr (requires { vector.arena(); }) {
+    return Memory<U>(size, &vector.arena());
+  } else {
+    return Memory<U>(size);
+  }
+}
+
+template <typename T, typename KeyExtractor>
+void RadixSort(T* data, T* scratch, const uint64_t size,
+               KeyExtractor& key_extractor) {
+  using Bits = decltype(ToRadixBits(key_extractor(*data)));
+
+  constexpr uint64_t PassesAmount = sizeof(Bits) * 8 / RadixDigitBits;
+
+  uint64_t* counts = new uint64_t[PassesAmount * RadixBucketsAmount]();
+
+  for (uint64_t idx = 0; idx < size; idx++) {
+    Bits bits = ToRadixBits(key_extractor(data[idx]));
+
+    for (uint64_t pass = 0; pass < PassesAmount; pass++) {
+      counts[pass * RadixBucketsAmount +
+             ((bits >> (pass * RadixDigitBits)) & (RadixBucketsAmount - 1))]++;
+    }
+  }
+
+  T* from = data;
+  T* to = scratch;
+
+  for (uint64_t pass = 0; pass < PassesAmount; pass++) {
+    uint64_t* pass_counts = counts + pass * RadixBucketsAmount;
+    uint64_t shift = pass * RadixDigitBits;
+
+    // A digit shared by every key doesn't reorder anything.
+    if (pass_counts[(ToRadixBits(key_extractor(*from)) >> shift) &
+                    (RadixBucketsAmount - 1)] == size) {
+      continue;
+    }
+
+    uint64_t offset = 0;
+
+    for (uint64_t bucket = 0; bucket < RadixBucketsAmount; bucket++) {
+      uint64_t bucket_size = pass_counts[bucket];
+
+      pass_counts[bucket] = offset;
+      offset += bucket_size;
+    }
+
+    for (uint64_t idx = 0; idx < size; idx++) {
+      Bits bits = ToRadixBits(key_extractor(from[idx]));
+
+      std::memcpy(static_cast<void*>(
+                      to + pass_counts[(bits >> shift) &
+                                       (RadixBucketsAmount - 1)]++),
+                  static_cast<const void*>(from + idx), sizeof(T));
+    }
+
+    std::swap(from, to);
+  }
+
+  if (from != data) {
+    std::memcpy(static_cast<void*>(data), static_cast<const void*>(from),
+                size * sizeof(T));
+  }
+
+  delete[] counts;
+}
+
+// Stable LSD radix sort by an arithmetic key taken from every element.
+template <typename T, template <typename> class Memory, typename KeyExtractor>
+void RadixSort(Vector<T, Memory>& vector, KeyExtractor key_extractor) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Radix sort scatters elements bytewise");
+
+  uint64_t size = vector.size();
+
+  if (size < RadixSmallSortSize) {
+    std::stable_sort(vector.data(), vector.data() + size,
+                     [&key_extractor](const T& lhs, const T& rhs) {
+                       return ToRadixBits(key_extractor(lhs)) <
+                              ToRadixBits(key_extractor(rhs));
+                     });
+
+    return;
+  }
+
+  Memory<T> scratch = MakeScratchMemory<T>(vector, size);
+
+  RadixSort(vector.data(), scratch.data(), size, key_extractor);
+}
+
+template <typename T, template <typename> class Memory>
+void RadixSort(Vector<T, Memory>& vector) {
+  RadixSort(vector, [](const T& element) { return element; });
+}
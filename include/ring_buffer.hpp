@@ -0,0 +1,367 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "memory.hpp"
+#include "utilities.hpp"
+
+// Copies amount elements to or from the ring position pos, wrapping around
+// the end of the buffer with at most two memcpy calls.
+template <typename T>
+void CopyToRing(T* ring, const uint64_t mask, const uint64_t pos,
+                const T* elements, const uint64_t amount) {
+  uint64_t offset = pos & mask;
+  uint64_t first_part = std::min(amount, mask + 1 - offset);
+
+  if (first_part != 0) {
+    std::memcpy(static_cast<void*>(ring + offset), elements,
+                first_part * sizeof(T));
+  }
+
+  if (first_part != amount) {
+    std::memcpy(static_cast<void*>(ring), elements + first_part,
+                (amount - first_part) * sizeof(T));
+  }
+}
+
+template <typename T>
+void CopyFromRing(const T* ring, const uint64_t mask, const uint64_t pos,
+                  T* elements, const uint64_t amount) {
+  uint64_t offset = pos & mask;
+  uint64_t first_part = std::min(amount, mask + 1 - offset);
+
+  if (first_part != 0) {
+    std::memcpy(static_cast<void*>(elements), ring + offset,
+                first_part * sizeof(T));
+  }
+
+  if (first_part != amount) {
+    std::memcpy(static_cast<void*>(elements + first_part), ring,
+                (amount - first_part) * sizeof(T));
+  }
+}
+
+// Circular buffer with a power of two capacity. Head and tail are running
+// counters, so positions are masked only on access and a full buffer is
+// told apart from an empty one without a spare slot. A growable buffer
+// doubles its capacity instead of rejecting pushes.
+template <typename T, template <typename> class Memory = DefaultMemory>
+class RingBuffer : public Memory<T> {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Ring buffers move elements with memcpy");
+
+ public:
+  explicit RingBuffer(const uint64_t capacity, const bool is_growable = false);
+
+  template <typename Resource>
+  RingBuffer(const uint64_t capacity, Resource* resource,
+             const bool is_growable = false);
+
+  RingBuffer(const RingBuffer& buffer) = delete;
+  RingBuffer(RingBuffer&& buffer) = delete;
+
+  RingBuffer& operator=(const RingBuffer& buffer) = delete;
+  RingBuffer& operator=(RingBuffer&& buffer) = delete;
+
+  ~RingBuffer() = default;
+
+  bool empty() const;
+  bool full() const;
+  uint64_t size() const;
+  uint64_t capacity() const;
+
+  void reserve(const uint64_t new_capacity);
+
+  void clear();
+
+  bool push(const T& element);
+  bool pop(T& element);
+
+  // Bulk versions return the amount of pushed or popped elements.
+  uint64_t push(std::span<const T> elements);
+  uint64_t pop(std::span<T> elements);
+
+  T& operator[](const uint64_t idx);
+  const T& operator[](const uint64_t idx) const;
+
+  T& front();
+  const T& front() const;
+
+  T& back();
+  const T& back() const;
+
+ private:
+  uint64_t mask_;
+  uint64_t head_;
+  uint64_t tail_;
+
+  bool is_growable_;
+};
+
+// Lock-free ring buffer for exactly one producer and one consumer thread.
+// Each side owns its index on a separate cache line and keeps a cached copy
+// of the other one, refreshing it only when the buffer looks full or empty.
+template <typename T, template <typename> class Memory = DefaultMemory>
+class SpscRingBuffer : public Memory<T> {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Ring buffers move elements with memcpy");
+
+ public:
+  explicit SpscRingBuffer(const uint64_t capacity);
+
+  template <typename Resource>
+  SpscRingBuffer(const uint64_t capacity, Resource* resource);
+
+  SpscRingBuffer(const SpscRingBuffer& buffer) = delete;
+  SpscRingBuffer(SpscRingBuffer&& buffer) = delete;
+
+  SpscRingBuffer& operator=(const SpscRingBuffer& buffer) = delete;
+  SpscRingBuffer& operator=(SpscRingBuffer&& buffer) = delete;
+
+  ~SpscRingBuffer() = default;
+
+  bool empty() const;
+  uint64_t size() const;
+  uint64_t capacity() const;
+
+  // Producer side.
+  bool try_push(const T& element);
+  uint64_t push(std::span<const T> elements);
+
+  // Consumer side.
+  bool try_pop(T& element);
+  uint64_t pop(std::span<T> elements);
+
+ private:
+  uint64_t mask_;
+
+  alignas(CacheLineSize) std::atomic<uint64_t> tail_;
+  uint64_t cached_head_;
+
+  alignas(CacheLineSize) std::atomic<uint64_t> head_;
+  uint64_t cached_tail_;
+};
+
+template <typename T, template <typename> class Memory>
+RingBuffer<T, Memory>::RingBuffer(const uint64_t capacity,
+                                  const bool is_growable)
+    : Memory<T>(std::bit_ceil(std::max<uint64_t>(capacity, 1))),
+      mask_(std::bit_ceil(std::max<uint64_t>(capacity, 1)) - 1),
+      head_(0),
+      tail_(0),
+      is_growable_(is_growable) {}
+
+template <typename T, template <typename> class Memory>
+template <typename Resource>
+RingBuffer<T, Memory>::RingBuffer(const uint64_t capacity, Resource* resource,
+                                  const bool is_growable)
+    : Memory<T>(std::bit_ceil(std::max<uint64_t>(capacity, 1)), resource),
+      mask_(std::bit_ceil(std::max<uint64_t>(capacity, 1)) - 1),
+      head_(0),
+      tail_(0),
+      is_growable_(is_growable) {}
+
+template <typename T, template <typename> class Memory>
+bool RingBuffer<T, Memory>::empty() const {
+  return (head_ == tail_);
+}
+
+template <typename T, template <typename> class Memory>
+bool RingBuffer<T, Memory>::full() const {
+  return (size() == capacity());
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t RingBuffer<T, Memory>::size() const {
+  return tail_ - head_;
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t RingBuffer<T, Memory>::capacity() const {
+  return mask_ + 1;
+}
+
+template <typename T, template <typename> class Memory>
+void RingBuffer<T, Memory>::reserve(const uint64_t new_capacity) {
+  if (new_capacity <= capacity()) {
+    return;
+  }
+
+  uint64_t size = this->size();
+
+  // Unwraps the elements to the buffer start, as Realloc moves a prefix.
+  char* bytes = reinterpret_cast<char*>(this->data());
+  std::rotate(bytes, bytes + (head_ & mask_) * sizeof(T),
+              bytes + capacity() * sizeof(T));
+
+  this->Realloc(size, std::bit_ceil(new_capacity));
+
+  mask_ = std::bit_ceil(new_capacity) - 1;
+  head_ = 0;
+  tail_ = size;
+}
+
+template <typename T, template <typename> class Memory>
+void RingBuffer<T, Memory>::clear() {
+  head_ = 0;
+  tail_ = 0;
+}
+
+template <typename T, template <typename> class Memory>
+bool RingBuffer<T, Memory>::push(const T& element) {
+  return (push(std::span<const T>(&element, 1)) == 1);
+}
+
+template <typename T, template <typename> class Memory>
+bool RingBuffer<T, Memory>::pop(T& element) {
+  return (pop(std::span<T>(&element, 1)) == 1);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t RingBuffer<T, Memory>::push(std::span<const T> elements) {
+  if (is_growable_) {
+    reserve(size() + elements.size());
+  }
+
+  uint64_t amount = std::min<uint64_t>(elements.size(), capacity() - size());
+
+  CopyToRing(this->data(), mask_, tail_, elements.data(), amount);
+  tail_ += amount;
+
+  return amount;
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t RingBuffer<T, Memory>::pop(std::span<T> elements) {
+  uint64_t amount = std::min<uint64_t>(elements.size(), size());
+
+  CopyFromRing(this->data(), mask_, head_, elements.data(), amount);
+  head_ += amount;
+
+  return amount;
+}
+
+template <typename T, template <typename> class Memory>
+T& RingBuffer<T, Memory>::operator[](const uint64_t idx) {
+  return this->data()[(head_ + idx) & mask_];
+}
+
+template <typename T, template <typename> class Memory>
+const T& RingBuffer<T, Memory>::operator[](const uint64_t idx) const {
+  return this->data()[(head_ + idx) & mask_];
+}
+
+template <typename T, template <typename> class Memory>
+T& RingBuffer<T, Memory>::front() {
+  assert(!empty());
+
+  return (*this)[0];
+}
+
+template <typename T, template <typename> class Memory>
+const T& RingBuffer<T, Memory>::front() const {
+  assert(!empty());
+
+  return (*this)[0];
+}
+
+template <typename T, template <typename> class Memory>
+T& RingBuffer<T, Memory>::back() {
+  assert(!empty());
+
+  return (*this)[size() - 1];
+}
+
+template <typename T, template <typename> class Memory>
+const T& RingBuffer<T, Memory>::back() const {
+  assert(!empty());
+
+  return (*this)[size() - 1];
+}
+
+template <typename T, template <typename> class Memory>
+SpscRingBuffer<T, Memory>::SpscRingBuffer(const uint64_t capacity)
+    : Memory<T>(std::bit_ceil(std::max<uint64_t>(capacity, 1))),
+      mask_(std::bit_ceil(std::max<uint64_t>(capacity, 1)) - 1),
+      tail_(0),
+      cached_head_(0),
+      head_(0),
+      cached_tail_(0) {}
+
+template <typename T, template <typename> class Memory>
+template <typename Resource>
+SpscRingBuffer<T, Memory>::SpscRingBuffer(const uint64_t capacity,
+                                          Resource* resource)
+    : Memory<T>(std::bit_ceil(std::max<uint64_t>(capacity, 1)), resource),
+      mask_(std::bit_ceil(std::max<uint64_t>(capacity, 1)) - 1),
+      tail_(0),
+      cached_head_(0),
+      head_(0),
+      cached_tail_(0) {}
+
+template <typename T, template <typename> class Memory>
+bool SpscRingBuffer<T, Memory>::empty() const {
+  return (size() == 0);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SpscRingBuffer<T, Memory>::size() const {
+  uint64_t head = head_.load(std::memory_order_acquire);
+
+  return tail_.load(std::memory_order_acquire) - head;
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SpscRingBuffer<T, Memory>::capacity() const {
+  return mask_ + 1;
+}
+
+template <typename T, template <typename> class Memory>
+bool SpscRingBuffer<T, Memory>::try_push(const T& element) {
+  return (push(std::span<const T>(&element, 1)) == 1);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SpscRingBuffer<T, Memory>::push(std::span<const T> elements) {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+  if (capacity() - (tail - cached_head_) < elements.size()) {
+    cached_head_ = head_.load(std::memory_order_acquire);
+  }
+
+  uint64_t amount =
+      std::min<uint64_t>(elements.size(), capacity() - (tail - cached_head_));
+
+  CopyToRing(this->data(), mask_, tail, elements.data(), amount);
+  tail_.store(tail + amount, std::memory_order_release);
+
+  return amount;
+}
+
+template <typename T, template <typename> class Memory>
+bool SpscRingBuffer<T, Memory>::try_pop(T& element) {
+  return (pop(std::span<T>(&element, 1)) == 1);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SpscRingBuffer<T, Memory>::pop(std::span<T> elements) {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+
+  if (cached_tail_ - head < elements.size()) {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+  }
+
+  uint64_t amount = std::min<uint64_t>(elements.size(), cached_tail_ - head);
+
+  CopyFromRing(this->data(), mask_, head, elements.data(), amount);
+  head_.store(head + amount, std::memory_order_release);
+
+  return amount;
+}
@@ -0,0 +1,496 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include "memory.hpp"
+#include "utilities.hpp"
+
+// Elements live in chunks of geometrically growing size. Chunk k holds
+// BaseChunkSize << k elements, so the chunk of an index is found with a bit
+// scan and push_back never moves already stored elements.
+template <typename T, template <typename> class Memory = DefaultMemory>
+class SegmentedVector {
+  template <bool IsConst>
+  class basic_iterator {
+    using Container =
+        std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+
+    basic_iterator();
+    basic_iterator(Container* vector, const uint64_t idx);
+    basic_iterator(basic_iterator&& it) = default;
+    basic_iterator(const basic_iterator& it) = default;
+
+    ~basic_iterator() = default;
+
+    basic_iterator& operator=(basic_iterator&& it) = default;
+    basic_iterator& operator=(const basic_iterator& it) = default;
+
+    bool operator==(const basic_iterator& it) const;
+    bool operator!=(const basic_iterator& it) const;
+    bool operator<(const basic_iterator& it) const;
+    bool operator>(const basic_iterator& it) const;
+    bool operator>=(const basic_iterator& it) const;
+    bool operator<=(const basic_iterator& it) const;
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    basic_iterator& operator++();
+    basic_iterator operator++(int);
+
+    basic_iterator& operator--();
+    basic_iterator operator--(int);
+
+    basic_iterator& operator+=(const difference_type diff);
+    basic_iterator& operator-=(const difference_type diff);
+
+    basic_iterator operator+(const difference_type diff) const;
+    basic_iterator operator-(const difference_type diff) const;
+
+    difference_type operator-(const basic_iterator& it) const;
+
+    reference operator[](const difference_type diff) const;
+
+   private:
+    Container* vector_;
+    uint64_t idx_;
+  };
+
+ public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  SegmentedVector();
+
+  SegmentedVector(const SegmentedVector& vector) = delete;
+  SegmentedVector(SegmentedVector&& vector);
+
+  SegmentedVector& operator=(const SegmentedVector& vector) = delete;
+  SegmentedVector& operator=(SegmentedVector&& vector);
+
+  ~SegmentedVector();
+
+  bool empty() const;
+  uint64_t size() const;
+  uint64_t capacity() const;
+
+  void reserve(const uint64_t new_capacity);
+  void shrink_to_fit();
+
+  void clear();
+
+  void push_back(T&& element);
+  void pop_back();
+
+  T& at(const uint64_t idx);
+  const T& at(const uint64_t idx) const;
+
+  T& operator[](const uint64_t idx);
+  const T& operator[](const uint64_t idx) const;
+
+  T& front();
+  const T& front() const;
+
+  T& back();
+  const T& back() const;
+
+  iterator begin();
+  iterator end();
+
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+ private:
+  static constexpr uint64_t BaseChunkSize =
+      std::bit_ceil(std::max<uint64_t>(0x400 / sizeof(T), 1));
+  static constexpr uint64_t MaxChunksAmount =
+      64 - std::countr_zero(BaseChunkSize);
+
+  static uint64_t GetChunkIdx(const uint64_t idx);
+  static uint64_t GetChunkBegin(const uint64_t chunk_idx);
+  static uint64_t GetChunkSize(const uint64_t chunk_idx);
+
+  void AddChunk();
+  void DestructChunks(const uint64_t from, const uint64_t to);
+
+  Memory<T>* chunks_[MaxChunksAmount];
+  uint64_t chunks_amount_;
+
+  uint64_t size_;
+};
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::basic_iterator()
+    : vector_(nullptr), idx_(0) {}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::basic_iterator(
+    Container* vector, const uint64_t idx)
+    : vector_(vector), idx_(idx) {}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+bool SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator==(
+    const basic_iterator& it) const {
+  return idx_ == it.idx_;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+bool SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator!=(
+    const basic_iterator& it) const {
+  return idx_ != it.idx_;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+bool SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator<(
+    const basic_iterator& it) const {
+  return idx_ < it.idx_;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+bool SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator>(
+    const basic_iterator& it) const {
+  return idx_ > it.idx_;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+bool SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator>=(
+    const basic_iterator& it) const {
+  return idx_ >= it.idx_;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+bool SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator<=(
+    const basic_iterator& it) const {
+  return idx_ <= it.idx_;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::reference
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator*() const {
+  return (*vector_)[idx_];
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::pointer
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator->() const {
+  return &(*vector_)[idx_];
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>&
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator++() {
+  idx_++;
+
+  return *this;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator++(int) {
+  basic_iterator temp = *this;
+  ++(*this);
+
+  return temp;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>&
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator--() {
+  idx_--;
+
+  return *this;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator--(int) {
+  basic_iterator temp = *this;
+  --(*this);
+
+  return temp;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>&
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator+=(
+    const difference_type diff) {
+  idx_ = static_cast<uint64_t>(static_cast<difference_type>(idx_) + diff);
+
+  return *this;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>&
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator-=(
+    const difference_type diff) {
+  idx_ = static_cast<uint64_t>(static_cast<difference_type>(idx_) - diff);
+
+  return *this;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator+(
+    const difference_type diff) const {
+  basic_iterator temp = *this;
+  temp += diff;
+
+  return temp;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator-(
+    const difference_type diff) const {
+  basic_iterator temp = *this;
+  temp -= diff;
+
+  return temp;
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+std::ptrdiff_t SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator-(
+    const basic_iterator& it) const {
+  return static_cast<difference_type>(idx_) -
+         static_cast<difference_type>(it.idx_);
+}
+
+template <typename T, template <typename> class Memory>
+template <bool IsConst>
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::reference
+SegmentedVector<T, Memory>::basic_iterator<IsConst>::operator[](
+    const difference_type diff) const {
+  return *(*this + diff);
+}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>::SegmentedVector()
+    : chunks_(), chunks_amount_(0), size_(0) {}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>::SegmentedVector(SegmentedVector&& vector)
+    : chunks_(),
+      chunks_amount_(std::exchange(vector.chunks_amount_, 0)),
+      size_(std::exchange(vector.size_, 0)) {
+  std::copy(vector.chunks_, vector.chunks_ + chunks_amount_, chunks_);
+}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>& SegmentedVector<T, Memory>::operator=(
+    SegmentedVector&& vector) {
+  std::swap(chunks_, vector.chunks_);
+  std::swap(chunks_amount_, vector.chunks_amount_);
+  std::swap(size_, vector.size_);
+
+  return *this;
+}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>::~SegmentedVector() {
+  clear();
+
+  // Newer chunks first, so stack based memory is released in LIFO order.
+  while (chunks_amount_ != 0) {
+    delete chunks_[--chunks_amount_];
+  }
+}
+
+template <typename T, template <typename> class Memory>
+bool SegmentedVector<T, Memory>::empty() const {
+  return (size_ == 0);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SegmentedVector<T, Memory>::size() const {
+  return size_;
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SegmentedVector<T, Memory>::capacity() const {
+  return GetChunkBegin(chunks_amount_);
+}
+
+template <typename T, template <typename> class Memory>
+void SegmentedVector<T, Memory>::reserve(const uint64_t new_capacity) {
+  while (capacity() < new_capacity) {
+    AddChunk();
+  }
+}
+
+template <typename T, template <typename> class Memory>
+void SegmentedVector<T, Memory>::shrink_to_fit() {
+  while ((chunks_amount_ != 0) &&
+         (GetChunkBegin(chunks_amount_ - 1) >= size_)) {
+    delete chunks_[--chunks_amount_];
+  }
+}
+
+template <typename T, template <typename> class Memory>
+void SegmentedVector<T, Memory>::clear() {
+  if (size_ != 0) {
+    DestructChunks(0, GetChunkIdx(size_ - 1) + 1);
+  }
+
+  size_ = 0;
+}
+
+template <typename T, template <typename> class Memory>
+void SegmentedVector<T, Memory>::push_back(T&& element) {
+  if (size_ == capacity()) {
+    AddChunk();
+  }
+
+  new (&(*this)[size_]) T(std::forward<T>(element));
+  size_++;
+}
+
+template <typename T, template <typename> class Memory>
+void SegmentedVector<T, Memory>::pop_back() {
+  assert(size_);
+
+  (*this)[--size_].~T();
+}
+
+template <typename T, template <typename> class Memory>
+T& SegmentedVector<T, Memory>::at(const uint64_t idx) {
+  assert(idx < size_);
+
+  return (*this)[idx];
+}
+
+template <typename T, template <typename> class Memory>
+const T& SegmentedVector<T, Memory>::at(const uint64_t idx) const {
+  assert(idx < size_);
+
+  return (*this)[idx];
+}
+
+template <typename T, template <typename> class Memory>
+T& SegmentedVector<T, Memory>::operator[](const uint64_t idx) {
+  uint64_t chunk_idx = GetChunkIdx(idx);
+
+  return chunks_[chunk_idx]->data()[idx - GetChunkBegin(chunk_idx)];
+}
+
+template <typename T, template <typename> class Memory>
+const T& SegmentedVector<T, Memory>::operator[](const uint64_t idx) const {
+  uint64_t chunk_idx = GetChunkIdx(idx);
+
+  return chunks_[chunk_idx]->data()[idx - GetChunkBegin(chunk_idx)];
+}
+
+template <typename T, template <typename> class Memory>
+T& SegmentedVector<T, Memory>::front() {
+  assert(size_);
+
+  return (*this)[0];
+}
+
+template <typename T, template <typename> class Memory>
+const T& SegmentedVector<T, Memory>::front() const {
+  assert(size_);
+
+  return (*this)[0];
+}
+
+template <typename T, template <typename> class Memory>
+T& SegmentedVector<T, Memory>::back() {
+  assert(size_);
+
+  return (*this)[size_ - 1];
+}
+
+template <typename T, template <typename> class Memory>
+const T& SegmentedVector<T, Memory>::back() const {
+  assert(size_);
+
+  return (*this)[size_ - 1];
+}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>::iterator SegmentedVector<T, Memory>::begin() {
+  return {this, 0};
+}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>::iterator SegmentedVector<T, Memory>::end() {
+  return {this, size_};
+}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>::const_iterator SegmentedVector<T, Memory>::cbegin()
+    const {
+  return {this, 0};
+}
+
+template <typename T, template <typename> class Memory>
+SegmentedVector<T, Memory>::const_iterator SegmentedVector<T, Memory>::cend()
+    const {
+  return {this, size_};
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SegmentedVector<T, Memory>::GetChunkIdx(const uint64_t idx) {
+  return static_cast<uint64_t>(std::bit_width(idx / BaseChunkSize + 1)) - 1;
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SegmentedVector<T, Memory>::GetChunkBegin(const uint64_t chunk_idx) {
+  return BaseChunkSize * ((1ull << chunk_idx) - 1);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t SegmentedVector<T, Memory>::GetChunkSize(const uint64_t chunk_idx) {
+  return BaseChunkSize << chunk_idx;
+}
+
+template <typename T, template <typename> class Memory>
+void SegmentedVector<T, Memory>::AddChunk() {
+  assert(chunks_amount_ < MaxChunksAmount);
+
+  chunks_[chunks_amount_] = new Memory<T>(GetChunkSize(chunks_amount_));
+  chunks_amount_++;
+}
+
+template <typename T, template <typename> class Memory>
+void SegmentedVector<T, Memory>::DestructChunks(const uint64_t from,
+                                                const uint64_t to) {
+  for (uint64_t chunk_idx = from; chunk_idx < to; chunk_idx++) {
+    uint64_t chunk_begin = GetChunkBegin(chunk_idx);
+
+    Destruct(chunks_[chunk_idx]->data(), 0,
+             std::min(size_, chunk_begin + GetChunkSize(chunk_idx)) -
+                 chunk_begin);
+  }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+
+#include "vector.hpp"
+#include "vector_view.hpp"
+
+enum class SimdLevel {
+  Scalar,
+  Sse,
+  Avx2,
+  Avx512,
+};
+
+SimdLevel GetSimdLevel();
+
+template <typename T>
+constexpr bool IsSimdType =
+    std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
+    std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Kernels over raw arrays, instantiated for the IsSimdType types. Index
+// results are size when nothing matches or the array is empty.
+template <typename T>
+uint64_t SimdFind(const T* data, const uint64_t size, const T value);
+
+template <typename T>
+uint64_t SimdCount(const T* data, const uint64_t size, const T value);
+
+template <typename T>
+uint64_t SimdMinElement(const T* data, const uint64_t size);
+
+template <typename T>
+uint64_t SimdMaxElement(const T* data, const uint64_t size);
+
+// Floating point sums are accumulated lane-wise, so their rounding differs
+// from a sequential sum.
+template <typename T>
+T SimdSum(const T* data, const uint64_t size);
+
+// Read-only algorithms work on views, vectors are viewed as a whole.
+template <typename T>
+uint64_t Find(const VectorView<T> view, const T& value) {
+  if constexpr (IsSimdType<T>) {
+    return SimdFind(view.data(), view.size(), value);
+  } else {
+    return static_cast<uint64_t>(std::find(view.begin(), view.end(), value) -
+                                 view.begin());
+  }
+}
+
+template <typename T>
+uint64_t Count(const VectorView<T> view, const T& value) {
+  if constexpr (IsSimdType<T>) {
+    return SimdCount(view.data(), view.size(), value);
+  } else {
+    return static_cast<uint64_t>(std::count(view.begin(), view.end(), value));
+  }
+}
+
+template <typename T>
+bool Contains(const VectorView<T> view, const T& value) {
+  return Find(view, value) != view.size();
+}
+
+template <typename T>
+uint64_t MinElement(const VectorView<T> view) {
+  if constexpr (IsSimdType<T>) {
+    return SimdMinElement(view.data(), view.size());
+  } else {
+    return static_cast<uint64_t>(
+        std::min_element(view.begin(), view.end()) - view.begin());
+  }
+}
+
+template <typename T>
+uint64_t MaxElement(const VectorView<T> view) {
+  if constexpr (IsSimdType<T>) {
+    return SimdMaxElement(view.data(), view.size());
+  } else {
+    return static_cast<uint64_t>(
+        std::max_element(view.begin(), view.end()) - view.begin());
+  }
+}
+
+template <typename T>
+T Sum(const VectorView<T> view) {
+  if constexpr (IsSimdType<T>) {
+    return SimdSum(view.data(), view.size());
+  } else {
+    return std::accumulate(view.begin(), view.end(), T());
+  }
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t Find(const Vector<T, Memory>& vector, const T& value) {
+  return Find(VectorView<T>(vector), value);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t Count(const Vector<T, Memory>& vector, const T& value) {
+  return Count(VectorView<T>(vector), value);
+}
+
+template <typename T, template <typename> class Memory>
+bool Contains(const Vector<T, Memory>& vector, const T& value) {
+  return Contains(VectorView<T>(vector), value);
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t MinElement(const Vector<T, Memory>& vector) {
+  return MinElement(VectorView<T>(vector));
+}
+
+template <typename T, template <typename> class Memory>
+uint64_t MaxElement(const Vector<T, Memory>& vector) {
+  return MaxElement(VectorView<T>(vector));
+}
+
+template <typename T, template <typename> class Memory>
+T Sum(const Vector<T, Memory>& vector) {
+  return Sum(VectorView<T>(vector));
+}
+
+// Bit vectors go through the BitView kernels.
+uint64_t Count(const Vector<bool>& vector, const bool value);
+uint64_t Find(const Vector<bool>& vector, const bool value);
+bool Contains(const Vector<bool>& vector, const bool value);
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+class SlabEngine {
+ public:
+  static constexpr uint64_t SlabSize = 0x10000;
+  static constexpr uint64_t MinClassShift = 3;
+  static constexpr uint64_t MaxClassShift = 11;
+  static constexpr uint64_t ClassesAmount = MaxClassShift - MinClassShift + 1;
+  static constexpr uint64_t MaxClassSize = 1ull << MaxClassShift;
+  static constexpr uint64_t WarmSlabsAmount = 1;
+
+  SlabEngine(const SlabEngine& engine) = delete;
+  SlabEngine(SlabEngine&& engine) = delete;
+
+  SlabEngine& operator=(const SlabEngine& engine) = delete;
+  SlabEngine& operator=(SlabEngine&& engine) = delete;
+
+  SlabEngine();
+  ~SlabEngine();
+
+  void* Allocate(const uint64_t bytes);
+  void Deallocate(void* ptr, const uint64_t bytes);
+  void* Reallocate(void* ptr, const uint64_t new_bytes);
+
+  uint64_t GetReservedBytes() const;
+  void Trim(const uint64_t target_bytes);
+
+  // The default engine is per thread. Memory taken from it has to be freed
+  // and reallocated by the same thread, before that thread exits.
+  static SlabEngine& GetDefault();
+
+ private:
+  struct Slab {
+    uint64_t class_idx_;
+    uint64_t class_size_;
+    uint64_t chunk_size_;
+
+    void* free_list_;
+    char* bump_;
+    char* end_;
+
+    uint64_t free_amount_;
+    uint64_t capacity_;
+
+    Slab* prev_;
+    Slab* next_;
+
+    char* GetData() const;
+  };
+
+  static constexpr uint64_t LargeClassIdx = ClassesAmount;
+  static constexpr uint64_t SlabHeaderSize = 0x80;
+
+  static_assert(sizeof(Slab) <= SlabHeaderSize);
+
+  explicit SlabEngine(const std::thread::id owner_thread);
+
+  bool IsOwnerThread() const;
+
+  static uint64_t GetClassIdx(const uint64_t bytes);
+  static Slab* GetSlabByPtr(void* ptr);
+
+  static void Link(Slab*& list, Slab* slab);
+  static void Unlink(Slab*& list, Slab* slab);
+
+  Slab* CreateSlab(const uint64_t class_idx, const uint64_t chunk_size);
+  void DestroySlab(Slab* slab);
+
+  void* AllocateLarge(const uint64_t bytes);
+
+  Slab* available_[ClassesAmount];
+  Slab* full_[ClassesAmount];
+  Slab* large_;
+
+  uint64_t reserved_bytes_;
+
+  // Set for the per thread default engines only, other engines may be
+  // handed between threads.
+  std::thread::id owner_thread_;
+};
+
+template <typename T>
+class SlabPool {
+ public:
+  SlabPool(const SlabPool& pool) = default;
+  SlabPool(SlabPool&& pool) = default;
+
+  SlabPool& operator=(const SlabPool& pool) = default;
+  SlabPool& operator=(SlabPool&& pool) = default;
+
+  SlabPool();
+  SlabPool(SlabEngine& engine);
+  ~SlabPool() = default;
+
+  T* Allocate(const uint64_t amount);
+  void Deallocate(T* ptr, const uint64_t amount);
+  T* Reallocate(T* ptr, const uint64_t old_size, const uint64_t new_size);
+
+  uint64_t GetReservedBytes() const;
+  void Trim(const uint64_t target_bytes);
+
+  SlabEngine& engine() const;
+
+ private:
+  SlabEngine* engine_;
+};
+
+template <typename T>
+SlabPool<T>::SlabPool() : engine_(&SlabEngine::GetDefault()) {}
+
+template <typename T>
+SlabPool<T>::SlabPool(SlabEngine& engine) : engine_(&engine) {}
+
+template <typename T>
+T* SlabPool<T>::Allocate(const uint64_t amount) {
+  static_assert(alignof(T) <= SlabEngine::SlabSize);
+
+  return reinterpret_cast<T*>(engine_->Allocate(amount * sizeof(T)));
+}
+
+template <typename T>
+void SlabPool<T>::Deallocate(T* ptr, const uint64_t amount) {
+  engine_->Deallocate(ptr, amount * sizeof(T));
+}
+
+template <typename T>
+T* SlabPool<T>::Reallocate(T* ptr, const uint64_t,
+                           const uint64_t new_size) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Slab reallocation relocates memory bytewise");
+
+  return reinterpret_cast<T*>(engine_->Reallocate(ptr, new_size * sizeof(T)));
+}
+
+template <typename T>
+uint64_t SlabPool<T>::GetReservedBytes() const {
+  return engine_->GetReservedBytes();
+}
+
+template <typename T>
+void SlabPool<T>::Trim(const uint64_t target_bytes) {
+  engine_->Trim(target_bytes);
+}
+
+template <typename T>
+SlabEngine& SlabPool<T>::engine() const {
+  return *engine_;
+}
@@ -0,0 +1,638 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "memory.hpp"
+#include "utilities.hpp"
+
+// Proxy for one row: a tuple of references into every column. Assignment
+// writes through to the columns, and a moved row moves every field out, so
+// rows can be moved around by algorithms.
+template <typename... Fields>
+class SoARow : public std::tuple<Fields&...> {
+ public:
+  using std::tuple<Fields&...>::tuple;
+  using std::tuple<Fields&...>::operator=;
+
+  SoARow(const SoARow& row) = default;
+  SoARow(SoARow&& row) = default;
+
+  SoARow& operator=(const SoARow& row) = default;
+  SoARow& operator=(SoARow&& row);
+
+  ~SoARow() = default;
+
+  operator std::tuple<Fields...>() &&;
+
+  template <uint64_t Idx>
+  auto& get() const;
+
+  friend void swap(SoARow lhs, SoARow rhs) {
+    [&]<uint64_t... Indices>(std::integer_sequence<uint64_t, Indices...>) {
+      using std::swap;
+
+      (swap(std::get<Indices>(lhs), std::get<Indices>(rhs)), ...);
+    }(std::make_integer_sequence<uint64_t, sizeof...(Fields)>());
+  }
+};
+
+template <uint64_t Idx, typename T, template <typename> class Memory>
+class SoAColumn : public Memory<T> {
+ public:
+  using Memory<T>::Memory;
+};
+
+template <template <typename> class Memory, typename Indices,
+          typename... Fields>
+class SoAColumns;
+
+template <template <typename> class Memory, uint64_t... Indices,
+          typename... Fields>
+class SoAColumns<Memory, std::integer_sequence<uint64_t, Indices...>,
+                 Fields...> : public SoAColumn<Indices, Fields, Memory>... {
+ public:
+  SoAColumns();
+
+  template <typename Resource>
+  explicit SoAColumns(Resource* resource);
+};
+
+// Every field is stored in its own column allocated through Memory, so scans
+// over one field only pull that field into the cache.
+//
+// Columns grow one after another, so on a stack arena only the last one
+// could be extended in place and the others would leave dead blocks behind
+// on every growth. StackMemory is rejected for that reason.
+template <template <typename> class Memory, typename... Fields>
+class BasicSoAVector
+    : private SoAColumns<
+          Memory, std::make_integer_sequence<uint64_t, sizeof...(Fields)>,
+          Fields...> {
+  static_assert(!std::is_same_v<Memory<char>, StackMemory<char>>,
+                "Columns of a SoAVector can't share one stack arena");
+
+  using Columns =
+      SoAColumns<Memory,
+                 std::make_integer_sequence<uint64_t, sizeof...(Fields)>,
+                 Fields...>;
+
+  template <uint64_t Idx>
+  using Field = std::tuple_element_t<Idx, std::tuple<Fields...>>;
+
+  template <uint64_t Idx>
+  using Column = SoAColumn<Idx, Field<Idx>, Memory>;
+
+  template <bool IsConst>
+  class basic_iterator {
+    using Container =
+        std::conditional_t<IsConst, const BasicSoAVector, BasicSoAVector>;
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::tuple<Fields...>;
+    using reference =
+        std::conditional_t<IsConst, SoARow<const Fields...>, SoARow<Fields...>>;
+    using pointer = void;
+
+    basic_iterator();
+    basic_iterator(Container* vector, const uint64_t idx);
+    basic_iterator(basic_iterator&& it) = default;
+    basic_iterator(const basic_iterator& it) = default;
+
+    ~basic_iterator() = default;
+
+    basic_iterator& operator=(basic_iterator&& it) = default;
+    basic_iterator& operator=(const basic_iterator& it) = default;
+
+    bool operator==(const basic_iterator& it) const;
+    bool operator!=(const basic_iterator& it) const;
+    bool operator<(const basic_iterator& it) const;
+    bool operator>(const basic_iterator& it) const;
+    bool operator>=(const basic_iterator& it) const;
+    bool operator<=(const basic_iterator& it) const;
+
+    reference operator*() const;
+
+    basic_iterator& operator++();
+    basic_iterator operator++(int);
+
+    basic_iterator& operator--();
+    basic_iterator operator--(int);
+
+    basic_iterator& operator+=(const difference_type diff);
+    basic_iterator& operator-=(const difference_type diff);
+
+    basic_iterator operator+(const difference_type diff) const;
+    basic_iterator operator-(const difference_type diff) const;
+
+    difference_type operator-(const basic_iterator& it) const;
+
+    reference operator[](const difference_type diff) const;
+
+   private:
+    Container* vector_;
+    uint64_t idx_;
+  };
+
+ public:
+  using value_type = std::tuple<Fields...>;
+  using reference = SoARow<Fields...>;
+  using const_reference = SoARow<const Fields...>;
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  BasicSoAVector();
+
+  template <typename Resource>
+  explicit BasicSoAVector(Resource* resource);
+
+  BasicSoAVector(const BasicSoAVector& vector) = delete;
+  BasicSoAVector(BasicSoAVector&& vector) = delete;
+
+  BasicSoAVector& operator=(const BasicSoAVector& vector) = delete;
+  BasicSoAVector& operator=(BasicSoAVector&& vector) = delete;
+
+  ~BasicSoAVector();
+
+  bool empty() const;
+  uint64_t size() const;
+  uint64_t capacity() const;
+
+  void reserve(const uint64_t new_capacity);
+  void resize(const uint64_t new_size);
+  void shrink_to_fit();
+
+  void clear();
+
+  void push_back(Fields... fields);
+  void pop_back();
+
+  reference at(const uint64_t idx);
+  const_reference at(const uint64_t idx) const;
+
+  reference operator[](const uint64_t idx);
+  const_reference operator[](const uint64_t idx) const;
+
+  reference front();
+  const_reference front() const;
+
+  reference back();
+  const_reference back() const;
+
+  template <uint64_t Idx>
+  Field<Idx>* data();
+
+  template <uint64_t Idx>
+  const Field<Idx>* data() const;
+
+  template <uint64_t Idx>
+  std::span<Field<Idx>> column();
+
+  template <uint64_t Idx>
+  std::span<const Field<Idx>> column() const;
+
+  iterator begin();
+  iterator end();
+
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+ private:
+  template <typename Function>
+  void ForEachColumn(Function&& function);
+
+  const static uint64_t base_capacity = 8;
+  const static uint64_t base_capacity_multiplier_ = 2;
+
+  uint64_t size_;
+  uint64_t capacity_;
+};
+
+template <typename... Fields>
+using SoAVector = BasicSoAVector<DefaultMemory, Fields...>;
+
+template <typename... Fields>
+SoARow<Fields...>& SoARow<Fields...>::operator=(SoARow&& row) {
+  [&]<uint64_t... Indices>(std::integer_sequence<uint64_t, Indices...>) {
+    ((std::get<Indices>(*this) = std::move(std::get<Indices>(row))), ...);
+  }(std::make_integer_sequence<uint64_t, sizeof...(Fields)>());
+
+  return *this;
+}
+
+template <typename... Fields>
+SoARow<Fields...>::operator std::tuple<Fields...>() && {
+  return [&]<uint64_t... Indices>(std::integer_sequence<uint64_t, Indices...>) {
+    return std::tuple<Fields...>(std::move(std::get<Indices>(*this))...);
+  }(std::make_integer_sequence<uint64_t, sizeof...(Fields)>());
+}
+
+template <typename... Fields>
+template <uint64_t Idx>
+auto& SoARow<Fields...>::get() const {
+  return std::get<Idx>(*this);
+}
+
+template <template <typename> class Memory, uint64_t... Indices,
+          typename... Fields>
+SoAColumns<Memory, std::integer_sequence<uint64_t, Indices...>,
+           Fields...>::SoAColumns()
+    : SoAColumn<Indices, Fields, Memory>(0)... {}
+
+template <template <typename> class Memory, uint64_t... Indices,
+          typename... Fields>
+template <typename Resource>
+SoAColumns<Memory, std::integer_sequence<uint64_t, Indices...>,
+           Fields...>::SoAColumns(Resource* resource)
+    : SoAColumn<Indices, Fields, Memory>(0, resource)... {}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::basic_iterator()
+    : vector_(nullptr), idx_(0) {}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::basic_iterator(
+    Container* vector, const uint64_t idx)
+    : vector_(vector), idx_(idx) {}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+bool BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator==(
+    const basic_iterator& it) const {
+  return idx_ == it.idx_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+bool BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator!=(
+    const basic_iterator& it) const {
+  return idx_ != it.idx_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+bool BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator<(
+    const basic_iterator& it) const {
+  return idx_ < it.idx_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+bool BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator>(
+    const basic_iterator& it) const {
+  return idx_ > it.idx_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+bool BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator>=(
+    const basic_iterator& it) const {
+  return idx_ >= it.idx_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+bool BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator<=(
+    const basic_iterator& it) const {
+  return idx_ <= it.idx_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::reference
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator*() const {
+  return (*vector_)[idx_];
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>&
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator++() {
+  idx_++;
+
+  return *this;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator++(int) {
+  basic_iterator temp = *this;
+  ++(*this);
+
+  return temp;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>&
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator--() {
+  idx_--;
+
+  return *this;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator--(int) {
+  basic_iterator temp = *this;
+  --(*this);
+
+  return temp;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>&
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator+=(
+    const difference_type diff) {
+  idx_ = static_cast<uint64_t>(static_cast<difference_type>(idx_) + diff);
+
+  return *this;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>&
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator-=(
+    const difference_type diff) {
+  idx_ = static_cast<uint64_t>(static_cast<difference_type>(idx_) - diff);
+
+  return *this;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator+(
+    const difference_type diff) const {
+  basic_iterator temp = *this;
+  temp += diff;
+
+  return temp;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator-(
+    const difference_type diff) const {
+  basic_iterator temp = *this;
+  temp -= diff;
+
+  return temp;
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+std::ptrdiff_t
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator-(
+    const basic_iterator& it) const {
+  return static_cast<difference_type>(idx_) -
+         static_cast<difference_type>(it.idx_);
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <bool IsConst>
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::reference
+BasicSoAVector<Memory, Fields...>::basic_iterator<IsConst>::operator[](
+    const difference_type diff) const {
+  return *(*this + diff);
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::BasicSoAVector()
+    : Columns(), size_(0), capacity_(0) {}
+
+template <template <typename> class Memory, typename... Fields>
+template <typename Resource>
+BasicSoAVector<Memory, Fields...>::BasicSoAVector(Resource* resource)
+    : Columns(resource), size_(0), capacity_(0) {}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::~BasicSoAVector() {
+  clear();
+
+  capacity_ = 0;
+}
+
+template <template <typename> class Memory, typename... Fields>
+bool BasicSoAVector<Memory, Fields...>::empty() const {
+  return (size_ == 0);
+}
+
+template <template <typename> class Memory, typename... Fields>
+uint64_t BasicSoAVector<Memory, Fields...>::size() const {
+  return size_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+uint64_t BasicSoAVector<Memory, Fields...>::capacity() const {
+  return capacity_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+void BasicSoAVector<Memory, Fields...>::reserve(uint64_t new_capacity) {
+  if (new_capacity <= capacity_) {
+    return;
+  }
+
+  new_capacity = std::max(new_capacity, capacity_ * base_capacity_multiplier_);
+
+  ForEachColumn([this, new_capacity](auto& column) {
+    column.Realloc(size_, new_capacity);
+  });
+  capacity_ = new_capacity;
+}
+
+template <template <typename> class Memory, typename... Fields>
+void BasicSoAVector<Memory, Fields...>::resize(const uint64_t new_size) {
+  if (new_size < size_) {
+    ForEachColumn([this, new_size](auto& column) {
+      Destruct(column.data(), new_size, size_);
+    });
+  } else {
+    reserve(new_size);
+
+    ForEachColumn([this, new_size](auto& column) {
+      Construct(column.data(), size_, new_size);
+    });
+  }
+
+  size_ = new_size;
+}
+
+template <template <typename> class Memory, typename... Fields>
+void BasicSoAVector<Memory, Fields...>::shrink_to_fit() {
+  if (size_ == capacity_) {
+    return;
+  }
+
+  ForEachColumn([this](auto& column) { column.Realloc(size_, size_); });
+  capacity_ = size_;
+}
+
+template <template <typename> class Memory, typename... Fields>
+void BasicSoAVector<Memory, Fields...>::clear() {
+  ForEachColumn([this](auto& column) { Destruct(column.data(), 0, size_); });
+  size_ = 0;
+}
+
+template <template <typename> class Memory, typename... Fields>
+void BasicSoAVector<Memory, Fields...>::push_back(Fields... fields) {
+  if (capacity_ == 0) {
+    reserve(base_capacity);
+  } else {
+    reserve(size_ + 1);
+  }
+
+  [&]<uint64_t... Indices>(std::integer_sequence<uint64_t, Indices...>) {
+    (new (data<Indices>() + size_) Field<Indices>(std::move(fields)), ...);
+  }(std::make_integer_sequence<uint64_t, sizeof...(Fields)>());
+
+  size_++;
+}
+
+template <template <typename> class Memory, typename... Fields>
+void BasicSoAVector<Memory, Fields...>::pop_back() {
+  assert(size_);
+
+  size_--;
+  ForEachColumn(
+      [this](auto& column) { Destruct(column.data(), size_, size_ + 1); });
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::reference
+BasicSoAVector<Memory, Fields...>::at(const uint64_t idx) {
+  assert(idx < size_);
+
+  return (*this)[idx];
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::const_reference
+BasicSoAVector<Memory, Fields...>::at(const uint64_t idx) const {
+  assert(idx < size_);
+
+  return (*this)[idx];
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::reference
+BasicSoAVector<Memory, Fields...>::operator[](const uint64_t idx) {
+  return [&]<uint64_t... Indices>(std::integer_sequence<uint64_t, Indices...>) {
+    return reference(data<Indices>()[idx]...);
+  }(std::make_integer_sequence<uint64_t, sizeof...(Fields)>());
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::const_reference
+BasicSoAVector<Memory, Fields...>::operator[](const uint64_t idx) const {
+  return [&]<uint64_t... Indices>(std::integer_sequence<uint64_t, Indices...>) {
+    return const_reference(data<Indices>()[idx]...);
+  }(std::make_integer_sequence<uint64_t, sizeof...(Fields)>());
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::reference
+BasicSoAVector<Memory, Fields...>::front() {
+  assert(size_);
+
+  return (*this)[0];
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::const_reference
+BasicSoAVector<Memory, Fields...>::front() const {
+  assert(size_);
+
+  return (*this)[0];
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::reference
+BasicSoAVector<Memory, Fields...>::back() {
+  assert(size_);
+
+  return (*this)[size_ - 1];
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::const_reference
+BasicSoAVector<Memory, Fields...>::back() const {
+  assert(size_);
+
+  return (*this)[size_ - 1];
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <uint64_t Idx>
+typename BasicSoAVector<Memory, Fields...>::template Field<Idx>*
+BasicSoAVector<Memory, Fields...>::data() {
+  return static_cast<Column<Idx>&>(*this).data();
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <uint64_t Idx>
+const typename BasicSoAVector<Memory, Fields...>::template Field<Idx>*
+BasicSoAVector<Memory, Fields...>::data() const {
+  return static_cast<const Column<Idx>&>(*this).data();
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <uint64_t Idx>
+std::span<typename BasicSoAVector<Memory, Fields...>::template Field<Idx>>
+BasicSoAVector<Memory, Fields...>::column() {
+  return {data<Idx>(), size_};
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <uint64_t Idx>
+std::span<const typename BasicSoAVector<Memory, Fields...>::template Field<Idx>>
+BasicSoAVector<Memory, Fields...>::column() const {
+  return {data<Idx>(), size_};
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::iterator
+BasicSoAVector<Memory, Fields...>::begin() {
+  return {this, 0};
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::iterator
+BasicSoAVector<Memory, Fields...>::end() {
+  return {this, size_};
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::const_iterator
+BasicSoAVector<Memory, Fields...>::cbegin() const {
+  return {this, 0};
+}
+
+template <template <typename> class Memory, typename... Fields>
+BasicSoAVector<Memory, Fields...>::const_iterator
+BasicSoAVector<Memory, Fields...>::cend() const {
+  return {this, size_};
+}
+
+template <template <typename> class Memory, typename... Fields>
+template <typename Function>
+void BasicSoAVector<Memory, Fields...>::ForEachColumn(Function&& function) {
+  [&]<uint64_t... Indices>(std::integer_sequence<uint64_t, Indices...>) {
+    (function(static_cast<Column<Indices>&>(*this)), ...);
+  }(std::make_integer_sequence<uint64_t, sizeof...(Fields)>());
+}
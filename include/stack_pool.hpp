@@ -1,20 +1,38 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
 #include <utility>
 
-template <typename T>
+#include "os_memory.hpp"
+#include "pool_stats.hpp"
+
+template <typename T, uint64_t StackSize = 0x400>
 class StackPool {
   static const uint64_t HeaderSignature = 0x22832997;
   static const uint64_t StackAmountMultiplier = 2;
-  static const uint64_t StackSize = 0x400;
-
+  static const uint64_t WarmStacksAmount = 1;
+
+#if !defined(NDEBUG) && !defined(STACK_POOL_NO_HEADERS)
+  static constexpr bool UseHeaders = true;
+#else
+  static constexpr bool UseHeaders = false;
+#endif
+
+  // A block placed with padding in front of it keeps the top it was placed
+  // at right before its data, so popping it gives the padding back. Debug
+  // headers always carry it as their last field, release blocks only when
+  // they're over-aligned for T.
   struct Header {
     const uint64_t signature_ = HeaderSignature;
     uint64_t size_;
+    char* top_;
 
-    Header(const uint64_t size);
+    Header(const uint64_t size, char* top);
   };
 
   struct Stack {
@@ -22,57 +40,152 @@ class StackPool {
     char* end_;
 
     char* ptr_;
+    char* back_ptr_;
+
+    // Blocks freed below the top can't be popped, their bytes stay dead
+    // until every block of that end is freed and the end collapses.
+    uint64_t blocks_amount_;
+    uint64_t live_bytes_;
+    uint64_t dead_bytes_;
+    uint64_t back_blocks_amount_;
+    uint64_t back_live_bytes_;
+    uint64_t back_dead_bytes_;
 
    public:
     Stack(const Stack& stack) = delete;
-    Stack(Stack&& stack) = default;
+    Stack(Stack&& stack) = delete;
 
     Stack& operator=(const Stack& stack) = delete;
-    Stack& operator=(Stack&& stack) = default;
+    Stack& operator=(Stack&& stack) = delete;
 
-    Stack(const uint64_t amount);
+    Stack(const uint64_t bytes);
     ~Stack();
 
-    T* Allocate(const uint64_t amount);
-    void Deallocate(T* ptr);
-    T* Reallocate(T* ptr, const uint64_t new_size);
+    T* Allocate(const uint64_t amount, const uint64_t alignment);
+    void Deallocate(T* ptr, const uint64_t amount, const uint64_t alignment);
+    T* Reallocate(T* ptr, const uint64_t old_size, const uint64_t new_size);
+
+    T* AllocateBack(const uint64_t amount, const uint64_t alignment);
+    void DeallocateBack(T* ptr, const uint64_t amount,
+                        const uint64_t alignment);
 
-    bool IsFits(const uint64_t amount) const;
+    void Reset();
+    void ResetBack();
+
+    bool IsFits(const uint64_t amount, const uint64_t alignment) const;
+    bool IsBackFits(const uint64_t amount, const uint64_t alignment) const;
+    bool IsEmpty() const;
+    bool IsBackEmpty() const;
+    bool IsTop(T* ptr, const uint64_t amount);
+    bool IsBackTop(T* ptr, const uint64_t amount, const uint64_t alignment);
+    bool IsExtendable(T* ptr, const uint64_t old_size,
+                      const uint64_t new_size);
 
    private:
-    Header* GetAreaHeader(T* ptr);
+    Header* GetAreaHeader(T* ptr, const uint64_t amount);
   };
 
+  static constexpr uint64_t StackBytes =
+      StackSize * (sizeof(T) + (UseHeaders ? sizeof(Header) : 0));
+
+  static char* AlignPtr(char* ptr, const uint64_t alignment);
+  static char* AlignPtrDown(char* ptr, const uint64_t alignment);
+  static constexpr uint64_t GetDataAlignment(const uint64_t alignment);
+  static constexpr uint64_t GetHeaderSize(const uint64_t alignment);
+  static void StoreTop(char* data_ptr, char* top);
+  static char* LoadTop(char* data_ptr);
+
  public:
+  struct Checkpoint {
+    uint64_t stack_idx_;
+    char* ptr_;
+    uint64_t blocks_amount_;
+    uint64_t live_bytes_;
+    uint64_t dead_bytes_;
+  };
+
   StackPool(const StackPool& pool) = delete;
-  StackPool(StackPool&& pool) = default;
+  StackPool(StackPool&& pool) = delete;
 
   StackPool& operator=(const StackPool& pool) = delete;
-  StackPool& operator=(StackPool&& pool) = default;
+  StackPool& operator=(StackPool&& pool) = delete;
 
   StackPool();
+  // A pool bound to a thread asserts that only that thread uses it.
+  explicit StackPool(const std::thread::id owner_thread);
   ~StackPool();
 
-  Stack* GetFreePoolEntry(const uint64_t size);
+  Stack* GetFreePoolEntry(const uint64_t size,
+                          const uint64_t alignment = alignof(T));
+  Stack* GetFreeBackPoolEntry(const uint64_t size,
+                              const uint64_t alignment = alignof(T));
   Stack* FindEntryByPtr(T* ptr, const uint64_t amount = 0);
 
+  T* Allocate(const uint64_t amount, const uint64_t alignment = alignof(T));
+  void Deallocate(T* ptr, const uint64_t amount,
+                  const uint64_t alignment = alignof(T));
+  T* Reallocate(T* ptr, const uint64_t old_size, const uint64_t new_size);
+  bool Extend(T* ptr, const uint64_t old_size, const uint64_t new_size);
+
+  T* AllocateBack(const uint64_t amount, const uint64_t alignment = alignof(T));
+  void DeallocateBack(T* ptr, const uint64_t amount,
+                      const uint64_t alignment = alignof(T));
+
+  Checkpoint Mark() const;
+  void Rewind(const Checkpoint& checkpoint);
+
+  Checkpoint MarkBack() const;
+  void RewindBack(const Checkpoint& checkpoint);
+
+  uint64_t GetReservedBytes() const;
+  PoolStats GetStats() const;
+
+  void Trim(const uint64_t target_bytes);
+  void SetHighWatermark(const uint64_t watermark_bytes);
+
  private:
+  static void PushStack(Stack**& stacks, uint64_t& stacks_amount,
+                        uint64_t& stacks_allocated, Stack* stack);
+
+  bool IsOwnerThread() const;
+
   uint64_t active_stack_;
   uint64_t stacks_amount_;
+  uint64_t stacks_allocated_;
   Stack** stacks_;
-};
 
-template <typename T>
-StackPool<T>::Header::Header(const uint64_t size) : size_(size) {}
+  // The back end grows down from the end of stacks_[0], which both ends
+  // share, and spills into stacks of its own.
+  uint64_t back_stack_;
+  uint64_t back_stacks_amount_;
+  uint64_t back_stacks_allocated_;
+  Stack** back_stacks_;
+
+  uint64_t high_watermark_;
+  std::thread::id owner_thread_;
 
-template <typename T>
-StackPool<T>::Stack::Stack(const uint64_t amount)
-    : begin_(new char[amount * (sizeof(T) + sizeof(Header))]()),
-      end_(begin_ + (amount * (sizeof(T) + sizeof(Header)))),
-      ptr_(begin_) {}
+  [[no_unique_address]] PoolCounters counters_;
+};
 
-template <typename T>
-StackPool<T>::Stack::~Stack() {
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Header::Header(const uint64_t size, char* top)
+    : size_(size), top_(top) {}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Stack::Stack(const uint64_t bytes)
+    : begin_(new char[bytes]()),
+      end_(begin_ + bytes),
+      ptr_(begin_),
+      back_ptr_(end_),
+      blocks_amount_(0),
+      live_bytes_(0),
+      dead_bytes_(0),
+      back_blocks_amount_(0),
+      back_live_bytes_(0),
+      back_dead_bytes_(0) {}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Stack::~Stack() {
   if (begin_ != nullptr) {
     delete[] begin_;
     begin_ = nullptr;
@@ -80,74 +193,288 @@ StackPool<T>::Stack::~Stack() {
 
   end_ = nullptr;
   ptr_ = nullptr;
+  back_ptr_ = nullptr;
 }
 
-template <typename T>
-T* StackPool<T>::StackPool::Stack::Allocate(const uint64_t amount) {
-  assert((ptr_ + sizeof(Header) + sizeof(T) * amount) <= end_);
+template <typename T, uint64_t StackSize>
+T* StackPool<T, StackSize>::StackPool::Stack::Allocate(
+    const uint64_t amount, const uint64_t alignment) {
+  const uint64_t header_size = GetHeaderSize(alignment);
+  char* data_ptr = AlignPtr(ptr_ + header_size, GetDataAlignment(alignment));
 
-  char* saved_ptr = ptr_;
+  assert((data_ptr + sizeof(T) * amount) <= back_ptr_);
 
-  new (saved_ptr) Header(sizeof(T) * amount);
-  ptr_ += sizeof(Header) + sizeof(T) * amount;
+  if constexpr (UseHeaders) {
+    new (data_ptr - header_size) Header(sizeof(T) * amount, ptr_);
+  } else if (header_size != 0) {
+    StoreTop(data_ptr, ptr_);
+  }
+  ptr_ = data_ptr + sizeof(T) * amount;
+  blocks_amount_++;
+  live_bytes_ += sizeof(T) * amount;
 
-  return reinterpret_cast<T*>(saved_ptr + sizeof(Header));
+  return reinterpret_cast<T*>(data_ptr);
 }
 
-template <typename T>
-void StackPool<T>::StackPool::Stack::Deallocate(T* ptr) {
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::StackPool::Stack::Deallocate(
+    T* ptr, [[maybe_unused]] const uint64_t amount, const uint64_t alignment) {
   char* char_ptr = reinterpret_cast<char*>(ptr);
-  Header* header_ptr = GetAreaHeader(ptr);
+  const uint64_t header_size = GetHeaderSize(alignment);
+
+  if constexpr (UseHeaders) {
+    GetAreaHeader(ptr, amount);
+  }
 
-  assert((char_ptr + header_ptr->size_) == ptr_);
+  assert((char_ptr >= begin_) && ((char_ptr + amount * sizeof(T)) <= ptr_));
+  assert(blocks_amount_ > 0);
 
-  ptr_ -= (sizeof(Header) + header_ptr->size_);
+  live_bytes_ -= amount * sizeof(T);
+
+  if (--blocks_amount_ == 0) {
+    Reset();
+    return;
+  }
+
+  if ((char_ptr + amount * sizeof(T)) != ptr_) {
+    dead_bytes_ += header_size + amount * sizeof(T);
+    return;
+  }
+
+  ptr_ = (header_size != 0) ? LoadTop(char_ptr) : char_ptr;
 }
 
-template <typename T>
-T* StackPool<T>::StackPool::Stack::Reallocate(T* ptr, uint64_t new_size) {
+template <typename T, uint64_t StackSize>
+T* StackPool<T, StackSize>::StackPool::Stack::Reallocate(
+    T* ptr, [[maybe_unused]] const uint64_t old_size, const uint64_t new_size) {
   if (ptr == nullptr) {
-    return Allocate(new_size);
+    return Allocate(new_size, alignof(T));
   }
 
   char* char_ptr = reinterpret_cast<char*>(ptr);
 
-  Header* header_ptr = GetAreaHeader(ptr);
-  uint64_t old_size = header_ptr->size_;
+  assert((char_ptr + old_size * sizeof(T)) == ptr_);
+  assert((char_ptr + new_size * sizeof(T)) <= back_ptr_);
 
-  assert((char_ptr + old_size) == ptr_);
-  assert((char_ptr + new_size * sizeof(T)) <= end_);
+  if constexpr (UseHeaders) {
+    GetAreaHeader(ptr, old_size)->size_ = new_size * sizeof(T);
+  }
 
-  ptr_ += (new_size * sizeof(T) - old_size);
-  header_ptr->size_ = new_size * sizeof(T);
+  ptr_ = char_ptr + new_size * sizeof(T);
+  live_bytes_ = live_bytes_ - old_size * sizeof(T) + new_size * sizeof(T);
 
   return ptr;
 }
 
-template <typename T>
-bool StackPool<T>::StackPool::Stack::IsFits(const uint64_t amount) const {
-  return (ptr_ + sizeof(Header) + amount * sizeof(T)) <= end_;
+template <typename T, uint64_t StackSize>
+T* StackPool<T, StackSize>::StackPool::Stack::AllocateBack(
+    const uint64_t amount, const uint64_t alignment) {
+  assert(IsBackFits(amount, alignment));
+
+  const uint64_t header_size = GetHeaderSize(alignment);
+  char* data_ptr =
+      AlignPtrDown(back_ptr_ - sizeof(T) * amount, GetDataAlignment(alignment));
+
+  if constexpr (UseHeaders) {
+    new (data_ptr - header_size) Header(sizeof(T) * amount, back_ptr_);
+  } else if (header_size != 0) {
+    StoreTop(data_ptr, back_ptr_);
+  }
+  back_ptr_ = data_ptr - header_size;
+  back_blocks_amount_++;
+  back_live_bytes_ += sizeof(T) * amount;
+
+  return reinterpret_cast<T*>(data_ptr);
 }
 
-template <typename T>
-StackPool<T>::Header* StackPool<T>::Stack::GetAreaHeader(T* ptr) {
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::StackPool::Stack::DeallocateBack(
+    T* ptr, const uint64_t amount, const uint64_t alignment) {
+  char* char_ptr = reinterpret_cast<char*>(ptr);
+  const uint64_t header_size = GetHeaderSize(alignment);
+
+  if constexpr (UseHeaders) {
+    GetAreaHeader(ptr, amount);
+  }
+
+  assert(((char_ptr - header_size) >= back_ptr_) &&
+         ((char_ptr + amount * sizeof(T)) <= end_));
+  assert(back_blocks_amount_ > 0);
+
+  back_live_bytes_ -= amount * sizeof(T);
+
+  if (--back_blocks_amount_ == 0) {
+    ResetBack();
+    return;
+  }
+
+  if ((char_ptr - header_size) != back_ptr_) {
+    back_dead_bytes_ += header_size + amount * sizeof(T);
+    return;
+  }
+
+  back_ptr_ = (header_size != 0) ? LoadTop(char_ptr)
+                                  : char_ptr + amount * sizeof(T);
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::StackPool::Stack::Reset() {
+  ptr_ = begin_;
+  blocks_amount_ = 0;
+  live_bytes_ = 0;
+  dead_bytes_ = 0;
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::StackPool::Stack::ResetBack() {
+  back_ptr_ = end_;
+  back_blocks_amount_ = 0;
+  back_live_bytes_ = 0;
+  back_dead_bytes_ = 0;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::StackPool::Stack::IsFits(
+    const uint64_t amount, const uint64_t alignment) const {
+  char* data_ptr =
+      AlignPtr(ptr_ + GetHeaderSize(alignment), GetDataAlignment(alignment));
+
+  return (data_ptr + amount * sizeof(T)) <= back_ptr_;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::StackPool::Stack::IsBackFits(
+    const uint64_t amount, const uint64_t alignment) const {
+  uint64_t block_bytes = GetHeaderSize(alignment) + amount * sizeof(T) +
+                         GetDataAlignment(alignment) - 1;
+
+  return static_cast<uint64_t>(back_ptr_ - ptr_) >= block_bytes;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::StackPool::Stack::IsEmpty() const {
+  return ptr_ == begin_;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::StackPool::Stack::IsBackEmpty() const {
+  return back_ptr_ == end_;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::StackPool::Stack::IsTop(T* ptr,
+                                                      const uint64_t amount) {
+  return (reinterpret_cast<char*>(ptr) + amount * sizeof(T)) == ptr_;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::StackPool::Stack::IsBackTop(
+    T* ptr, [[maybe_unused]] const uint64_t amount, const uint64_t alignment) {
+  return (reinterpret_cast<char*>(ptr) - GetHeaderSize(alignment)) ==
+         back_ptr_;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::StackPool::Stack::IsExtendable(
+    T* ptr, const uint64_t old_size, const uint64_t new_size) {
+  return IsTop(ptr, old_size) &&
+         ((reinterpret_cast<char*>(ptr) + new_size * sizeof(T)) <= back_ptr_);
+}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Header* StackPool<T, StackSize>::Stack::GetAreaHeader(
+    T* ptr, const uint64_t amount) {
   char* char_ptr = reinterpret_cast<char*>(ptr);
   Header* header_ptr = reinterpret_cast<Header*>(char_ptr - sizeof(Header));
 
   assert(header_ptr->signature_ == HeaderSignature);
-  assert((header_ptr->size_ % sizeof(T)) == 0);
+  assert(header_ptr->size_ == amount * sizeof(T));
 
   return header_ptr;
 }
 
-template <typename T>
-StackPool<T>::StackPool()
-    : active_stack_(0), stacks_amount_(1), stacks_(new Stack*[1]()) {
-  stacks_[active_stack_] = new Stack(StackSize);
+template <typename T, uint64_t StackSize>
+char* StackPool<T, StackSize>::AlignPtr(char* ptr, const uint64_t alignment) {
+  return reinterpret_cast<char*>(
+      (reinterpret_cast<uint64_t>(ptr) + alignment - 1) & ~(alignment - 1));
+}
+
+template <typename T, uint64_t StackSize>
+char* StackPool<T, StackSize>::AlignPtrDown(char* ptr,
+                                            const uint64_t alignment) {
+  return reinterpret_cast<char*>(reinterpret_cast<uint64_t>(ptr) &
+                                 ~(alignment - 1));
+}
+
+template <typename T, uint64_t StackSize>
+constexpr uint64_t StackPool<T, StackSize>::GetDataAlignment(
+    const uint64_t alignment) {
+  if constexpr (UseHeaders) {
+    return std::max<uint64_t>(alignment, alignof(Header));
+  }
+
+  return alignment;
+}
+
+template <typename T, uint64_t StackSize>
+constexpr uint64_t StackPool<T, StackSize>::GetHeaderSize(
+    const uint64_t alignment) {
+  if constexpr (UseHeaders) {
+    return sizeof(Header);
+  }
+
+  return (alignment > alignof(T)) ? sizeof(char*) : 0;
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::StoreTop(char* data_ptr, char* top) {
+  std::memcpy(data_ptr - sizeof(top), &top, sizeof(top));
+}
+
+template <typename T, uint64_t StackSize>
+char* StackPool<T, StackSize>::LoadTop(char* data_ptr) {
+  char* top = nullptr;
+  std::memcpy(&top, data_ptr - sizeof(top), sizeof(top));
+
+  return top;
+}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::StackPool()
+    : active_stack_(0),
+      stacks_amount_(1),
+      stacks_allocated_(1),
+      stacks_(new Stack*[1]()),
+      back_stack_(0),
+      back_stacks_amount_(1),
+      back_stacks_allocated_(1),
+      back_stacks_(new Stack*[1]()),
+      high_watermark_(0),
+      owner_thread_(),
+      counters_() {
+  stacks_[active_stack_] = new Stack(StackBytes);
+  back_stacks_[back_stack_] = stacks_[active_stack_];
 }
 
-template <typename T>
-StackPool<T>::~StackPool() {
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::StackPool(const std::thread::id owner_thread)
+    : StackPool() {
+  owner_thread_ = owner_thread;
+}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::~StackPool() {
+  if (back_stacks_ != nullptr) {
+    for (uint64_t stack_idx = 1; stack_idx < back_stacks_amount_;
+         stack_idx++) {
+      delete back_stacks_[stack_idx];
+      back_stacks_[stack_idx] = nullptr;
+    }
+
+    delete[] back_stacks_;
+    back_stacks_ = nullptr;
+  }
+
   if (stacks_ == nullptr) {
     return;
   }
@@ -163,43 +490,431 @@ StackPool<T>::~StackPool() {
   stacks_ = nullptr;
 }
 
-template <typename T>
-StackPool<T>::Stack* StackPool<T>::GetFreePoolEntry(const uint64_t amount) {
-  assert(amount <= StackSize);
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Stack* StackPool<T, StackSize>::GetFreePoolEntry(
+    const uint64_t amount, const uint64_t alignment) {
+  counters_.OnEntryScan(1);
+
+  if (stacks_[active_stack_]->IsFits(amount, alignment)) {
+    return stacks_[active_stack_];
+  }
 
-  if (!stacks_[active_stack_]->IsFits(amount)) {
-    if ((active_stack_ + 1) > stacks_amount_) {
-      Stack** new_stack_pool =
-          new Stack*[stacks_amount_ * StackAmountMultiplier]();
+  uint64_t stack_bytes =
+      std::max(StackBytes, GetHeaderSize(alignment) + amount * sizeof(T) +
+                               GetDataAlignment(alignment) - 1);
 
-      for (uint64_t stack_idx = 0; stack_idx < stacks_amount_; stack_idx++) {
-        new_stack_pool[stack_idx] = stacks_[stack_idx];
-      }
+  if ((active_stack_ + 1) < stacks_amount_) {
+    stacks_[active_stack_ + 1]->Reset();
 
-      delete[] stacks_;
-      stacks_ = new_stack_pool;
+    if (!stacks_[active_stack_ + 1]->IsFits(amount, alignment)) {
+      delete stacks_[active_stack_ + 1];
+      stacks_[active_stack_ + 1] = new Stack(stack_bytes);
     }
 
-    stacks_[++active_stack_] = new Stack(StackSize);
+    return stacks_[++active_stack_];
   }
 
-  return stacks_[active_stack_];
+  PushStack(stacks_, stacks_amount_, stacks_allocated_, new Stack(stack_bytes));
+
+  return stacks_[++active_stack_];
+}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Stack* StackPool<T, StackSize>::GetFreeBackPoolEntry(
+    const uint64_t amount, const uint64_t alignment) {
+  counters_.OnEntryScan(1);
+
+  if (back_stacks_[back_stack_]->IsBackFits(amount, alignment)) {
+    return back_stacks_[back_stack_];
+  }
+
+  uint64_t stack_bytes =
+      std::max(StackBytes, GetHeaderSize(alignment) + amount * sizeof(T) +
+                               GetDataAlignment(alignment) - 1);
+
+  if ((back_stack_ + 1) < back_stacks_amount_) {
+    back_stacks_[back_stack_ + 1]->ResetBack();
+
+    if (!back_stacks_[back_stack_ + 1]->IsBackFits(amount, alignment)) {
+      delete back_stacks_[back_stack_ + 1];
+      back_stacks_[back_stack_ + 1] = new Stack(stack_bytes);
+    }
+
+    return back_stacks_[++back_stack_];
+  }
+
+  PushStack(back_stacks_, back_stacks_amount_, back_stacks_allocated_,
+            new Stack(stack_bytes));
+
+  return back_stacks_[++back_stack_];
 }
 
-template <typename T>
-StackPool<T>::Stack* StackPool<T>::FindEntryByPtr(T* t_ptr, const uint64_t amount) {
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Stack* StackPool<T, StackSize>::FindEntryByPtr(T* t_ptr, const uint64_t amount) {
   char* ptr = reinterpret_cast<char*>(t_ptr);
 
   for (uint64_t stack_idx = 0; stack_idx < stacks_amount_; stack_idx++) {
     if ((ptr >= stacks_[stack_idx]->begin_) &&
         ((ptr + amount * sizeof(T)) <= stacks_[stack_idx]->end_)) {
-      assert((stack_idx == active_stack_) &&
-             "Stack allocator can deallocate only top memory areas");
+      counters_.OnPtrScan(stack_idx + 1);
 
       return stacks_[stack_idx];
     }
   }
 
+  for (uint64_t stack_idx = 1; stack_idx < back_stacks_amount_; stack_idx++) {
+    if ((ptr >= back_stacks_[stack_idx]->begin_) &&
+        ((ptr + amount * sizeof(T)) <= back_stacks_[stack_idx]->end_)) {
+      counters_.OnPtrScan(stacks_amount_ + stack_idx);
+
+      return back_stacks_[stack_idx];
+    }
+  }
+
   assert(nullptr && "INVALID PTR");
   return nullptr;
 }
+
+template <typename T, uint64_t StackSize>
+T* StackPool<T, StackSize>::Allocate(const uint64_t amount,
+                                     const uint64_t alignment) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  counters_.OnAllocate(amount * sizeof(T));
+
+  return GetFreePoolEntry(amount, alignment)->Allocate(amount, alignment);
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::Deallocate(T* ptr, const uint64_t amount,
+                                         const uint64_t alignment) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  Stack* stack = FindEntryByPtr(ptr, amount);
+
+  counters_.OnFree(amount * sizeof(T));
+
+  stack->Deallocate(ptr, amount, alignment);
+
+  if (!stacks_[active_stack_]->IsEmpty()) {
+    return;
+  }
+
+  while ((active_stack_ > 0) && stacks_[active_stack_]->IsEmpty()) {
+    active_stack_--;
+  }
+
+  if (high_watermark_ && (GetReservedBytes() > high_watermark_)) {
+    Trim(high_watermark_);
+  }
+}
+
+template <typename T, uint64_t StackSize>
+T* StackPool<T, StackSize>::Reallocate(T* ptr, const uint64_t old_size,
+                                       const uint64_t new_size) {
+  if (ptr == nullptr) {
+    return Allocate(new_size);
+  }
+
+  if (Extend(ptr, old_size, new_size)) {
+    return ptr;
+  }
+
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Relocating reallocation copies memory bytewise");
+
+  T* new_ptr = Allocate(new_size);
+
+  std::memcpy(new_ptr, ptr, std::min(old_size, new_size) * sizeof(T));
+  Deallocate(ptr, old_size);
+
+  return new_ptr;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::Extend(T* ptr, const uint64_t old_size,
+                                     const uint64_t new_size) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  Stack* stack = FindEntryByPtr(ptr, old_size);
+
+  if (!stack->IsExtendable(ptr, old_size, new_size)) {
+    return false;
+  }
+
+  counters_.OnReallocate(old_size * sizeof(T), new_size * sizeof(T));
+
+  stack->Reallocate(ptr, old_size, new_size);
+
+  return true;
+}
+
+template <typename T, uint64_t StackSize>
+T* StackPool<T, StackSize>::AllocateBack(const uint64_t amount,
+                                         const uint64_t alignment) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  counters_.OnAllocate(amount * sizeof(T));
+
+  return GetFreeBackPoolEntry(amount, alignment)
+      ->AllocateBack(amount, alignment);
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::DeallocateBack(T* ptr, const uint64_t amount,
+                                             const uint64_t alignment) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  Stack* stack = FindEntryByPtr(ptr, amount);
+
+  counters_.OnFree(amount * sizeof(T));
+
+  stack->DeallocateBack(ptr, amount, alignment);
+
+  while ((back_stack_ > 0) && back_stacks_[back_stack_]->IsBackEmpty()) {
+    back_stack_--;
+  }
+}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Checkpoint StackPool<T, StackSize>::Mark() const {
+  const Stack* stack = stacks_[active_stack_];
+
+  return {active_stack_, stack->ptr_, stack->blocks_amount_,
+          stack->live_bytes_, stack->dead_bytes_};
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::Rewind(const Checkpoint& checkpoint) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  assert(checkpoint.stack_idx_ <= active_stack_);
+  assert((checkpoint.stack_idx_ < active_stack_) ||
+         (checkpoint.ptr_ <= stacks_[active_stack_]->ptr_));
+
+  Stack* stack = stacks_[checkpoint.stack_idx_];
+  uint64_t blocks_amount = 0;
+  uint64_t live_bytes = 0;
+
+  for (uint64_t stack_idx = checkpoint.stack_idx_ + 1;
+       stack_idx <= active_stack_; stack_idx++) {
+    blocks_amount += stacks_[stack_idx]->blocks_amount_;
+    live_bytes += stacks_[stack_idx]->live_bytes_;
+  }
+
+  if (stack->blocks_amount_ > checkpoint.blocks_amount_) {
+    blocks_amount += stack->blocks_amount_ - checkpoint.blocks_amount_;
+  }
+
+  if (stack->live_bytes_ > checkpoint.live_bytes_) {
+    live_bytes += stack->live_bytes_ - checkpoint.live_bytes_;
+  }
+
+  counters_.OnRewind(blocks_amount, live_bytes);
+
+  active_stack_ = checkpoint.stack_idx_;
+  stack->ptr_ = checkpoint.ptr_;
+  stack->blocks_amount_ = checkpoint.blocks_amount_;
+  stack->live_bytes_ = checkpoint.live_bytes_;
+  stack->dead_bytes_ = checkpoint.dead_bytes_;
+}
+
+template <typename T, uint64_t StackSize>
+StackPool<T, StackSize>::Checkpoint StackPool<T, StackSize>::MarkBack() const {
+  const Stack* stack = back_stacks_[back_stack_];
+
+  return {back_stack_, stack->back_ptr_, stack->back_blocks_amount_,
+          stack->back_live_bytes_, stack->back_dead_bytes_};
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::RewindBack(const Checkpoint& checkpoint) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  assert(checkpoint.stack_idx_ <= back_stack_);
+  assert((checkpoint.stack_idx_ < back_stack_) ||
+         (checkpoint.ptr_ >= back_stacks_[back_stack_]->back_ptr_));
+
+  Stack* stack = back_stacks_[checkpoint.stack_idx_];
+  uint64_t blocks_amount = 0;
+  uint64_t live_bytes = 0;
+
+  for (uint64_t stack_idx = checkpoint.stack_idx_ + 1;
+       stack_idx <= back_stack_; stack_idx++) {
+    blocks_amount += back_stacks_[stack_idx]->back_blocks_amount_;
+    live_bytes += back_stacks_[stack_idx]->back_live_bytes_;
+  }
+
+  if (stack->back_blocks_amount_ > checkpoint.blocks_amount_) {
+    blocks_amount += stack->back_blocks_amount_ - checkpoint.blocks_amount_;
+  }
+
+  if (stack->back_live_bytes_ > checkpoint.live_bytes_) {
+    live_bytes += stack->back_live_bytes_ - checkpoint.live_bytes_;
+  }
+
+  counters_.OnRewind(blocks_amount, live_bytes);
+
+  back_stack_ = checkpoint.stack_idx_;
+  stack->back_ptr_ = checkpoint.ptr_;
+  stack->back_blocks_amount_ = checkpoint.blocks_amount_;
+  stack->back_live_bytes_ = checkpoint.live_bytes_;
+  stack->back_dead_bytes_ = checkpoint.dead_bytes_;
+}
+
+template <typename T, uint64_t StackSize>
+uint64_t StackPool<T, StackSize>::GetReservedBytes() const {
+  uint64_t reserved_bytes = 0;
+
+  for (uint64_t stack_idx = 0; stack_idx < stacks_amount_; stack_idx++) {
+    reserved_bytes += static_cast<uint64_t>(stacks_[stack_idx]->end_ -
+                                            stacks_[stack_idx]->begin_);
+  }
+
+  for (uint64_t stack_idx = 1; stack_idx < back_stacks_amount_; stack_idx++) {
+    reserved_bytes += static_cast<uint64_t>(back_stacks_[stack_idx]->end_ -
+                                            back_stacks_[stack_idx]->begin_);
+  }
+
+  return reserved_bytes;
+}
+
+template <typename T, uint64_t StackSize>
+PoolStats StackPool<T, StackSize>::GetStats() const {
+  PoolStats stats = {};
+  counters_.Fill(stats);
+
+  stats.entries_amount_ = stacks_amount_;
+  stats.reserved_bytes_ = GetReservedBytes();
+
+  for (uint64_t stack_idx = 0; stack_idx < active_stack_; stack_idx++) {
+    stats.fragmented_bytes_ += static_cast<uint64_t>(
+        stacks_[stack_idx]->back_ptr_ - stacks_[stack_idx]->ptr_);
+  }
+
+  for (uint64_t stack_idx = 0; stack_idx <= active_stack_; stack_idx++) {
+    stats.fragmented_bytes_ += stacks_[stack_idx]->dead_bytes_;
+  }
+
+  for (uint64_t stack_idx = 0; stack_idx <= back_stack_; stack_idx++) {
+    stats.fragmented_bytes_ += back_stacks_[stack_idx]->back_dead_bytes_;
+  }
+
+  return stats;
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::Trim(const uint64_t target_bytes) {
+  assert(IsOwnerThread() && "Stack pool used from another thread");
+
+  uint64_t reserved_bytes = GetReservedBytes();
+
+  while ((stacks_amount_ > active_stack_ + 1 + WarmStacksAmount) &&
+         (reserved_bytes > target_bytes)) {
+    Stack* stack = stacks_[--stacks_amount_];
+
+    reserved_bytes -= static_cast<uint64_t>(stack->end_ - stack->begin_);
+
+    delete stack;
+    stacks_[stacks_amount_] = nullptr;
+  }
+
+  while ((back_stacks_amount_ > back_stack_ + 1 + WarmStacksAmount) &&
+         (reserved_bytes > target_bytes)) {
+    Stack* stack = back_stacks_[--back_stacks_amount_];
+
+    reserved_bytes -= static_cast<uint64_t>(stack->end_ - stack->begin_);
+
+    delete stack;
+    back_stacks_[back_stacks_amount_] = nullptr;
+  }
+
+  if (reserved_bytes <= target_bytes) {
+    return;
+  }
+
+  ReleasePhysicalMemory(stacks_[active_stack_]->ptr_,
+                        stacks_[active_stack_]->back_ptr_);
+
+  for (uint64_t stack_idx = active_stack_ + 1; stack_idx < stacks_amount_;
+       stack_idx++) {
+    ReleasePhysicalMemory(stacks_[stack_idx]->begin_, stacks_[stack_idx]->end_);
+  }
+
+  if (back_stack_ == 0) {
+    return;
+  }
+
+  ReleasePhysicalMemory(back_stacks_[back_stack_]->ptr_,
+                        back_stacks_[back_stack_]->back_ptr_);
+
+  for (uint64_t stack_idx = back_stack_ + 1; stack_idx < back_stacks_amount_;
+       stack_idx++) {
+    ReleasePhysicalMemory(back_stacks_[stack_idx]->begin_,
+                          back_stacks_[stack_idx]->end_);
+  }
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::SetHighWatermark(const uint64_t watermark_bytes) {
+  high_watermark_ = watermark_bytes;
+}
+
+template <typename T, uint64_t StackSize>
+void StackPool<T, StackSize>::PushStack(Stack**& stacks,
+                                        uint64_t& stacks_amount,
+                                        uint64_t& stacks_allocated,
+                                        Stack* stack) {
+  if ((stacks_amount + 1) > stacks_allocated) {
+    Stack** new_stacks = new Stack*[stacks_allocated * StackAmountMultiplier]();
+
+    for (uint64_t stack_idx = 0; stack_idx < stacks_amount; stack_idx++) {
+      new_stacks[stack_idx] = stacks[stack_idx];
+    }
+
+    delete[] stacks;
+    stacks = new_stacks;
+    stacks_allocated *= StackAmountMultiplier;
+  }
+
+  stacks[stacks_amount++] = stack;
+}
+
+template <typename T, uint64_t StackSize>
+bool StackPool<T, StackSize>::IsOwnerThread() const {
+  return (owner_thread_ == std::thread::id()) ||
+         (owner_thread_ == std::this_thread::get_id());
+}
+
+template <typename Arena>
+class ArenaScope {
+ public:
+  ArenaScope(const ArenaScope& scope) = delete;
+  ArenaScope(ArenaScope&& scope) = delete;
+
+  ArenaScope& operator=(const ArenaScope& scope) = delete;
+  ArenaScope& operator=(ArenaScope&& scope) = delete;
+
+  ArenaScope(Arena& arena);
+  ~ArenaScope();
+
+ private:
+  Arena& arena_;
+  typename Arena::Checkpoint checkpoint_;
+};
+
+template <typename Arena>
+ArenaScope<Arena>::ArenaScope(Arena& arena)
+    : arena_(arena), checkpoint_(arena.Mark()) {}
+
+template <typename Arena>
+ArenaScope<Arena>::~ArenaScope() {
+  arena_.Rewind(checkpoint_);
+}
+
+using StackArena = StackPool<char, 0x10000>;
+
+// The default arena is per thread. Memory taken from it has to be freed by
+// the same thread, before that thread exits, so containers on it must not
+// migrate between threads.
+StackArena& GetDefaultStackArena();
@@ -0,0 +1,533 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#include "memory.hpp"
+#include "parallel_algorithms.hpp"
+#include "radix_sort.hpp"
+#include "vector.hpp"
+
+// Strings packed back to back into one byte buffer and addressed by an
+// offset and a size each. Sorting and deduplication permute only the slots,
+// so the bytes of removed strings stay in the buffer until compact().
+//
+// Offsets and sizes are 32-bit to keep a slot in 8 bytes, so the buffer
+// holds at most MaxBytesSize bytes, removed strings included. Appending past
+// that throws std::length_error and leaves the vector unchanged.
+template <template <typename> class Memory = DefaultMemory>
+class BasicStringVector {
+  struct StringSlot {
+    uint32_t offset_;
+    uint32_t size_;
+  };
+
+ public:
+  static constexpr uint64_t MaxBytesSize = std::numeric_limits<uint32_t>::max();
+
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::string_view;
+    using reference = std::string_view;
+    using pointer = const std::string_view*;
+
+    const_iterator();
+    const_iterator(const BasicStringVector* vector, const uint64_t idx);
+    const_iterator(const_iterator&& it) = default;
+    const_iterator(const const_iterator& it) = default;
+
+    ~const_iterator() = default;
+
+    const_iterator& operator=(const_iterator&& it) = default;
+    const_iterator& operator=(const const_iterator& it) = default;
+
+    bool operator==(const const_iterator& it) const;
+    bool operator!=(const const_iterator& it) const;
+    bool operator<(const const_iterator& it) const;
+    bool operator>(const const_iterator& it) const;
+    bool operator>=(const const_iterator& it) const;
+    bool operator<=(const const_iterator& it) const;
+
+    reference operator*() const;
+
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    const_iterator& operator--();
+    const_iterator operator--(int);
+
+    const_iterator& operator+=(const difference_type diff);
+    const_iterator& operator-=(const difference_type diff);
+
+    const_iterator operator+(const difference_type diff) const;
+    const_iterator operator-(const difference_type diff) const;
+
+    difference_type operator-(const const_iterator& it) const;
+
+    reference operator[](const difference_type diff) const;
+
+   private:
+    const BasicStringVector* vector_;
+    uint64_t idx_;
+  };
+
+  BasicStringVector();
+
+  template <typename Resource>
+  explicit BasicStringVector(Resource* resource);
+
+  BasicStringVector(const BasicStringVector& vector) = delete;
+  BasicStringVector(BasicStringVector&& vector) = delete;
+
+  BasicStringVector& operator=(const BasicStringVector& vector) = delete;
+  BasicStringVector& operator=(BasicStringVector&& vector) = delete;
+
+  ~BasicStringVector() = default;
+
+  bool empty() const;
+  uint64_t size() const;
+
+  // Bytes held by the buffer, including ones of removed strings.
+  uint64_t bytes_size() const;
+  const char* bytes() const;
+
+  void reserve(const uint64_t strings_amount, const uint64_t bytes_amount);
+
+  void clear();
+
+  void push_back(const std::string_view string);
+  void pop_back();
+
+  // Appends strings stored back to back in bytes with one memcpy.
+  void append(const std::string_view bytes, std::span<const uint64_t> sizes);
+
+  // Appends the delimiter separated strings of bytes, the delimiters are
+  // copied along and skipped. A trailing delimiter doesn't start an empty
+  // string.
+  void append(const std::string_view bytes, const char delimiter);
+
+  std::string_view at(const uint64_t idx) const;
+  std::string_view operator[](const uint64_t idx) const;
+
+  std::string_view front() const;
+  std::string_view back() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  void sort();
+  void unique();
+
+  // Rewrites the buffer in the current order, dropping unreferenced bytes.
+  void compact();
+
+ private:
+  static StringSlot MakeSlot(const uint64_t offset, const uint64_t size);
+
+  std::string_view GetString(const StringSlot& slot) const;
+
+  uint64_t AppendBytes(const std::string_view bytes);
+
+  Vector<char, Memory> bytes_;
+  Vector<StringSlot, Memory> slots_;
+};
+
+using StringVector = BasicStringVector<DefaultMemory>;
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator::const_iterator()
+    : vector_(nullptr), idx_(0) {}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator::const_iterator(
+    const BasicStringVector* vector, const uint64_t idx)
+    : vector_(vector), idx_(idx) {}
+
+template <template <typename> class Memory>
+bool BasicStringVector<Memory>::const_iterator::operator==(
+    const const_iterator& it) const {
+  return idx_ == it.idx_;
+}
+
+template <template <typename> class Memory>
+bool BasicStringVector<Memory>::const_iterator::operator!=(
+    const const_iterator& it) const {
+  return idx_ != it.idx_;
+}
+
+template <template <typename> class Memory>
+bool BasicStringVector<Memory>::const_iterator::operator<(
+    const const_iterator& it) const {
+  return idx_ < it.idx_;
+}
+
+template <template <typename> class Memory>
+bool BasicStringVector<Memory>::const_iterator::operator>(
+    const const_iterator& it) const {
+  return idx_ > it.idx_;
+}
+
+template <template <typename> class Memory>
+bool BasicStringVector<Memory>::const_iterator::operator>=(
+    const const_iterator& it) const {
+  return idx_ >= it.idx_;
+}
+
+template <template <typename> class Memory>
+bool BasicStringVector<Memory>::const_iterator::operator<=(
+    const const_iterator& it) const {
+  return idx_ <= it.idx_;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator::reference
+BasicStringVector<Memory>::const_iterator::operator*() const {
+  return (*vector_)[idx_];
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator&
+BasicStringVector<Memory>::const_iterator::operator++() {
+  ++idx_;
+
+  return *this;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator
+BasicStringVector<Memory>::const_iterator::operator++(int) {
+  const_iterator temp = *this;
+  ++idx_;
+
+  return temp;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator&
+BasicStringVector<Memory>::const_iterator::operator--() {
+  --idx_;
+
+  return *this;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator
+BasicStringVector<Memory>::const_iterator::operator--(int) {
+  const_iterator temp = *this;
+  --idx_;
+
+  return temp;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator&
+BasicStringVector<Memory>::const_iterator::operator+=(
+    const difference_type diff) {
+  idx_ = static_cast<uint64_t>(static_cast<difference_type>(idx_) + diff);
+
+  return *this;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator&
+BasicStringVector<Memory>::const_iterator::operator-=(
+    const difference_type diff) {
+  idx_ = static_cast<uint64_t>(static_cast<difference_type>(idx_) - diff);
+
+  return *this;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator
+BasicStringVector<Memory>::const_iterator::operator+(
+    const difference_type diff) const {
+  const_iterator temp = *this;
+  temp += diff;
+
+  return temp;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator
+BasicStringVector<Memory>::const_iterator::operator-(
+    const difference_type diff) const {
+  const_iterator temp = *this;
+  temp -= diff;
+
+  return temp;
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator::difference_type
+BasicStringVector<Memory>::const_iterator::operator-(
+    const const_iterator& it) const {
+  return static_cast<difference_type>(idx_) -
+         static_cast<difference_type>(it.idx_);
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator::reference
+BasicStringVector<Memory>::const_iterator::operator[](
+    const difference_type diff) const {
+  return *(*this + diff);
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::BasicStringVector() : bytes_(), slots_() {}
+
+template <template <typename> class Memory>
+template <typename Resource>
+BasicStringVector<Memory>::BasicStringVector(Resource* resource)
+    : bytes_(resource), slots_(resource) {}
+
+template <template <typename> class Memory>
+bool BasicStringVector<Memory>::empty() const {
+  return slots_.empty();
+}
+
+template <template <typename> class Memory>
+uint64_t BasicStringVector<Memory>::size() const {
+  return slots_.size();
+}
+
+template <template <typename> class Memory>
+uint64_t BasicStringVector<Memory>::bytes_size() const {
+  return bytes_.size();
+}
+
+template <template <typename> class Memory>
+const char* BasicStringVector<Memory>::bytes() const {
+  return bytes_.data();
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::reserve(const uint64_t strings_amount,
+                                        const uint64_t bytes_amount) {
+  slots_.reserve(strings_amount);
+  bytes_.reserve(bytes_amount);
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::clear() {
+  slots_.clear();
+  bytes_.clear();
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::push_back(const std::string_view string) {
+  uint64_t offset = AppendBytes(string);
+
+  slots_.push_back(MakeSlot(offset, string.size()));
+}
+
+// Bytes are released only when the string is the last one in the buffer.
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::pop_back() {
+  assert(!empty());
+
+  StringSlot slot = slots_.back();
+  slots_.pop_back();
+
+  if (uint64_t(slot.offset_) + slot.size_ == bytes_.size()) {
+    bytes_.resize(slot.offset_, char());
+  }
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::append(const std::string_view bytes,
+                                       std::span<const uint64_t> sizes) {
+  assert(std::accumulate(sizes.begin(), sizes.end(), uint64_t(0)) <=
+         bytes.size());
+
+  uint64_t offset = AppendBytes(bytes);
+
+  slots_.reserve(slots_.size() + sizes.size());
+
+  for (uint64_t size : sizes) {
+    slots_.push_back(MakeSlot(offset, size));
+    offset += size;
+  }
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::append(const std::string_view bytes,
+                                       const char delimiter) {
+  uint64_t offset = AppendBytes(bytes);
+
+  const char* begin = bytes.data();
+  const char* end = begin + bytes.size();
+
+  while (begin != end) {
+    const char* found = static_cast<const char*>(
+        std::memchr(begin, delimiter, static_cast<uint64_t>(end - begin)));
+    const char* string_end = (found != nullptr) ? found : end;
+
+    uint64_t size = static_cast<uint64_t>(string_end - begin);
+    slots_.push_back(MakeSlot(offset, size));
+
+    offset += size;
+    begin = string_end;
+
+    if (found != nullptr) {
+      offset++;
+      begin++;
+    }
+  }
+}
+
+template <template <typename> class Memory>
+std::string_view BasicStringVector<Memory>::at(const uint64_t idx) const {
+  assert(idx < size());
+
+  return (*this)[idx];
+}
+
+template <template <typename> class Memory>
+std::string_view BasicStringVector<Memory>::operator[](
+    const uint64_t idx) const {
+  return GetString(slots_[idx]);
+}
+
+template <template <typename> class Memory>
+std::string_view BasicStringVector<Memory>::front() const {
+  assert(!empty());
+
+  return (*this)[0];
+}
+
+template <template <typename> class Memory>
+std::string_view BasicStringVector<Memory>::back() const {
+  assert(!empty());
+
+  return (*this)[size() - 1];
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator BasicStringVector<Memory>::begin()
+    const {
+  return {this, 0};
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator BasicStringVector<Memory>::end()
+    const {
+  return {this, size()};
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator BasicStringVector<Memory>::cbegin()
+    const {
+  return begin();
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::const_iterator BasicStringVector<Memory>::cend()
+    const {
+  return end();
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::sort() {
+  ParallelSort(slots_.begin(), slots_.end(),
+               [this](const StringSlot& lhs, const StringSlot& rhs) {
+                 return GetString(lhs) < GetString(rhs);
+               });
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::unique() {
+  auto last = std::unique(slots_.begin(), slots_.end(),
+                          [this](const StringSlot& lhs, const StringSlot& rhs) {
+                            return GetString(lhs) == GetString(rhs);
+                          });
+
+  slots_.resize(static_cast<uint64_t>(last - slots_.begin()), StringSlot());
+}
+
+template <template <typename> class Memory>
+void BasicStringVector<Memory>::compact() {
+  uint64_t live_size = 0;
+
+  for (const StringSlot& slot : std::span(slots_.data(), slots_.size())) {
+    live_size += slot.size_;
+  }
+
+  // The scratch is released before the buffer shrinks, so on a stack arena
+  // the buffer can be shrunk in place instead of under a live scratch.
+  {
+    Memory<char> scratch = MakeScratchMemory<char>(bytes_, live_size);
+    uint64_t offset = 0;
+
+    for (StringSlot& slot : std::span(slots_.data(), slots_.size())) {
+      if (slot.size_ != 0) {
+        std::memcpy(scratch.data() + offset, bytes_.data() + slot.offset_,
+                    slot.size_);
+      }
+
+      slot.offset_ = static_cast<uint32_t>(offset);
+      offset += slot.size_;
+    }
+
+    if (live_size != 0) {
+      std::memcpy(bytes_.data(), scratch.data(), live_size);
+    }
+  }
+
+  bytes_.resize(live_size, char());
+  bytes_.shrink_to_fit();
+}
+
+template <template <typename> class Memory>
+BasicStringVector<Memory>::StringSlot BasicStringVector<Memory>::MakeSlot(
+    const uint64_t offset, const uint64_t size) {
+  if (offset + size > MaxBytesSize) {
+    throw std::length_error("StringVector bytes exceed 32-bit offsets");
+  }
+
+  return {static_cast<uint32_t>(offset), static_cast<uint32_t>(size)};
+}
+
+template <template <typename> class Memory>
+std::string_view BasicStringVector<Memory>::GetString(
+    const StringSlot& slot) const {
+  return {bytes_.data() + slot.offset_, slot.size_};
+}
+
+// Bytes may be a view into the buffer itself, e.g. one of its strings, so
+// they are addressed by offset across the reallocation.
+template <template <typename> class Memory>
+uint64_t BasicStringVector<Memory>::AppendBytes(const std::string_view bytes) {
+  uint64_t offset = bytes_.size();
+
+  if (offset + bytes.size() > MaxBytesSize) {
+    throw std::length_error("StringVector bytes exceed 32-bit offsets");
+  }
+
+  if ((bytes.data() < bytes_.data()) ||
+      (bytes.data() >= bytes_.data() + bytes_.size())) {
+    bytes_.append_range(bytes);
+
+    return offset;
+  }
+
+  uint64_t source_offset = static_cast<uint64_t>(bytes.data() - bytes_.data());
+
+  bytes_.reserve(offset + bytes.size());
+  bytes_.append_range(
+      std::string_view(bytes_.data() + source_offset, bytes.size()));
+
+  return offset;
+}
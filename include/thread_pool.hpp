@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+class ThreadPool {
+ public:
+  using Task = void (*)(void* context, const uint64_t task_idx);
+
+  struct Job {
+    Task task_;
+    void* context_;
+    uint64_t task_idx_;
+
+    std::atomic<uint64_t>* pending_;
+  };
+
+  ThreadPool(const ThreadPool& pool) = delete;
+  ThreadPool(ThreadPool&& pool) = delete;
+
+  ThreadPool& operator=(const ThreadPool& pool) = delete;
+  ThreadPool& operator=(ThreadPool&& pool) = delete;
+
+  explicit ThreadPool(const uint64_t workers_amount);
+  ~ThreadPool();
+
+  // Runs task for every index in [0, tasks_amount) and returns once all of
+  // them are done. The calling thread runs queued jobs while it waits, so
+  // nested calls from inside a task are fine.
+  void Run(Task task, void* context, const uint64_t tasks_amount);
+
+  void Submit(const Job& job);
+  void Wait(const std::atomic<uint64_t>& pending);
+
+  uint64_t GetThreadsAmount() const;
+
+  static ThreadPool& GetDefault();
+
+ private:
+  struct WorkQueue {
+    std::mutex mutex_{};
+    std::deque<Job> jobs_{};
+  };
+
+  static constexpr uint64_t NoWorkerIdx = ~0ull;
+
+  void WorkerLoop(const uint64_t worker_idx);
+
+  bool TryRunJob();
+  bool TryPopJob(Job& job);
+  static bool TryTakeJob(WorkQueue& queue, Job& job, const bool from_back);
+  static void RunJob(const Job& job);
+
+  uint64_t GetWorkerIdx() const;
+
+  uint64_t workers_amount_;
+  std::thread* workers_;
+
+  // One queue per worker plus a shared one for jobs from outside threads.
+  // Owners take from the back, thieves from the front.
+  WorkQueue* queues_;
+
+  std::atomic<uint64_t> queued_jobs_;
+  std::atomic<uint64_t> sleeping_workers_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  bool stop_;
+};
+
+class TaskGroup {
+ public:
+  TaskGroup(const TaskGroup& group) = delete;
+  TaskGroup(TaskGroup&& group) = delete;
+
+  TaskGroup& operator=(const TaskGroup& group) = delete;
+  TaskGroup& operator=(TaskGroup&& group) = delete;
+
+  explicit TaskGroup(ThreadPool& pool = ThreadPool::GetDefault());
+  ~TaskGroup();
+
+  template <typename Function>
+  void Spawn(Function&& function);
+
+  void Wait();
+
+ private:
+  ThreadPool& pool_;
+  std::atomic<uint64_t> pending_;
+};
+
+constexpr uint64_t DefaultParallelThreshold = 0x100000;
+constexpr uint64_t ParallelTasksPerThread = 4;
+
+uint64_t GetParallelThreshold();
+void SetParallelThreshold(const uint64_t threshold_bytes);
+
+template <typename Function>
+void TaskGroup::Spawn(Function&& function) {
+  using Callable = std::decay_t<Function>;
+
+  pending_.fetch_add(1, std::memory_order_relaxed);
+
+  pool_.Submit({[](void* context, const uint64_t) {
+                  Callable* callable = reinterpret_cast<Callable*>(context);
+
+                  (*callable)();
+                  delete callable;
+                },
+                new Callable(std::forward<Function>(function)), 0, &pending_});
+}
+
+template <typename Function>
+void ParallelFor(const uint64_t from, const uint64_t to, Function&& function) {
+  ThreadPool& pool = ThreadPool::GetDefault();
+
+  struct Context {
+    Function& function_;
+    uint64_t from_;
+    uint64_t size_;
+    uint64_t tasks_amount_;
+  };
+
+  // Contiguous chunks in index order keep first-touch page placement with the
+  // thread that fills them.
+  Context context = {function, from, to - from,
+                     pool.GetThreadsAmount() * ParallelTasksPerThread};
+
+  pool.Run(
+      [](void* context_ptr, const uint64_t task_idx) {
+        Context& ctx = *reinterpret_cast<Context*>(context_ptr);
+
+        uint64_t chunk_from =
+            ctx.from_ + ctx.size_ * task_idx / ctx.tasks_amount_;
+        uint64_t chunk_to =
+            ctx.from_ + ctx.size_ * (task_idx + 1) / ctx.tasks_amount_;
+
+        if (chunk_from < chunk_to) {
+          ctx.function_(chunk_from, chunk_to);
+        }
+      },
+      &context, context.tasks_amount_);
+}
+
+// Runs serially during constant evaluation.
+template <typename T, bool IsParallelSafe, typename Function>
+constexpr void ForEachChunk(const uint64_t from, const uint64_t to,
+                            Function&& function) {
+  if constexpr (IsParallelSafe) {
+    if (!std::is_constant_evaluated() && (from < to) &&
+        ((to - from) * sizeof(T) >= GetParallelThreshold())) {
+      ParallelFor(from, to, function);
+
+      return;
+    }
+  }
+
+  function(from, to);
+}
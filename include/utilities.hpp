@@ -1,64 +1,105 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
+#include "thread_pool.hpp"
+
+constexpr uint64_t CacheLineSize = 0x40;
+
+// Element helpers use construct_at and destroy_at, so they also run during
+// constant evaluation. They only split work across the thread pool when the
+// operation is trivial, so user copies, moves and destructors always run on
+// the calling thread.
+
 template <class T>
-void Destruct(T* data, const uint64_t from, const uint64_t to) {
+constexpr void Destruct(T* data, const uint64_t from, const uint64_t to) {
+  if constexpr (std::is_trivially_destructible_v<T>) {
+    return;
+  }
+
   for (uint64_t cur_idx = from; cur_idx < to; cur_idx++) {
-    data[cur_idx].~T();
+    std::destroy_at(data + cur_idx);
   }
 }
 
 template <class T>
-void Construct(T* data, const uint64_t from, const uint64_t to,
-               T&& elem = T()) {
-  for (uint64_t cur_idx = from; cur_idx < to; cur_idx++) {
-    new (data + cur_idx) T(elem);
-  }
+constexpr void Construct(T* data, const uint64_t from, const uint64_t to,
+                         const T& elem = T()) {
+  ForEachChunk<T, std::is_trivially_copy_constructible_v<T>>(
+      from, to,
+      [data, &elem](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          std::construct_at(data + cur_idx, elem);
+        }
+      });
 }
 
 template <class T>
-void Construct(T* data, const uint64_t from, const uint64_t to,
-               const T* elements) {
-  for (uint64_t cur_idx = from; cur_idx < to; cur_idx++) {
-    new (data + cur_idx) T(elements[cur_idx]);
-  }
+constexpr void Construct(T* data, const uint64_t from, const uint64_t to,
+                         const T* elements) {
+  ForEachChunk<T, std::is_trivially_copy_constructible_v<T>>(
+      from, to,
+      [data, elements](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          std::construct_at(data + cur_idx, elements[cur_idx]);
+        }
+      });
 }
 
 template <class T>
-void MoveConstruct(T* data, const uint64_t from, const uint64_t to,
-                   T* elements) {
-  for (uint64_t cur_idx = from; cur_idx < to; cur_idx++) {
-    new (data + cur_idx) T(std::move(elements[cur_idx]));
-  }
+constexpr void MoveConstruct(T* data, const uint64_t from,
+                             const uint64_t to, T* elements) {
+  ForEachChunk<T, std::is_trivially_move_constructible_v<T>>(
+      from, to,
+      [data, elements](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          std::construct_at(data + cur_idx, std::move(elements[cur_idx]));
+        }
+      });
 }
 
 template <class T>
-void Assign(T* data, const uint64_t from, const uint64_t to, T&& elem = T()) {
-  for (uint64_t cur_idx = from; cur_idx < to; cur_idx++) {
-    data[cur_idx] = elem;
-  }
+constexpr void Assign(T* data, const uint64_t from, const uint64_t to,
+                      const T& elem = T()) {
+  ForEachChunk<T, std::is_trivially_copy_assignable_v<T>>(
+      from, to,
+      [data, &elem](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          data[cur_idx] = elem;
+        }
+      });
 }
 
 template <class T>
-void Assign(T* data, const uint64_t from, const uint64_t to,
-            const T* elements) {
-  for (uint64_t cur_idx = from; cur_idx < to; cur_idx++) {
-    data[cur_idx] = elements[cur_idx];
-  }
+constexpr void Assign(T* data, const uint64_t from, const uint64_t to,
+                      const T* elements) {
+  ForEachChunk<T, std::is_trivially_copy_assignable_v<T>>(
+      from, to,
+      [data, elements](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          data[cur_idx] = elements[cur_idx];
+        }
+      });
 }
 
 template <class T>
-void MoveAssign(T* data, const uint64_t from, const uint64_t to, T* elements) {
-  for (uint64_t cur_idx = from; cur_idx < to; cur_idx++) {
-    data[cur_idx] = std::move(elements[cur_idx]);
-  }
+constexpr void MoveAssign(T* data, const uint64_t from, const uint64_t to,
+                          T* elements) {
+  ForEachChunk<T, std::is_trivially_move_assignable_v<T>>(
+      from, to,
+      [data, elements](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          data[cur_idx] = std::move(elements[cur_idx]);
+        }
+      });
 }
 
 template <class T>
 char* Realloc(T* old_data, const uint64_t size, const uint64_t new_capacity) {
-  char* new_data = new char[new_capacity * sizeof(T)]();
+  char* new_data = new char[new_capacity * sizeof(T)];
   T* converted_new_data = reinterpret_cast<T*>(new_data);
 
   MoveConstruct(converted_new_data, 0, size, old_data);
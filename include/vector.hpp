@@ -3,16 +3,26 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
 
 #include "memory.hpp"
+#include "expression.hpp"
+#include "os_memory.hpp"
 #include "utilities.hpp"
+#include "vector_view.hpp"
 
 template <typename T, template <typename> class Memory = DefaultMemory>
 class Vector : public Memory<T> {
   class iterator : public std::iterator<std::random_access_iterator_tag, T> {
    public:
-    iterator();
-    iterator(T* ptr);
+    constexpr iterator();
+    constexpr iterator(T* ptr);
     iterator(iterator&& it) = default;
     iterator(const iterator& it) = default;
 
@@ -21,30 +31,30 @@ class Vector : public Memory<T> {
     iterator& operator=(iterator&& it) = default;
     iterator& operator=(const iterator& it) = default;
 
-    bool operator==(const iterator& it) const;
-    bool operator!=(const iterator& it) const;
-    bool operator<(const iterator& it) const;
-    bool operator>(const iterator& it) const;
-    bool operator>=(const iterator& it) const;
-    bool operator<=(const iterator& it) const;
+    constexpr bool operator==(const iterator& it) const;
+    constexpr bool operator!=(const iterator& it) const;
+    constexpr bool operator<(const iterator& it) const;
+    constexpr bool operator>(const iterator& it) const;
+    constexpr bool operator>=(const iterator& it) const;
+    constexpr bool operator<=(const iterator& it) const;
 
-    T& operator*() const;
+    constexpr T& operator*() const;
 
-    iterator& operator++();
-    iterator operator++(int);
+    constexpr iterator& operator++();
+    constexpr iterator operator++(int);
 
-    iterator& operator--();
-    iterator operator--(int);
+    constexpr iterator& operator--();
+    constexpr iterator operator--(int);
 
-    iterator& operator+=(const std::ptrdiff_t diff);
-    iterator& operator-=(const std::ptrdiff_t diff);
+    constexpr iterator& operator+=(const std::ptrdiff_t diff);
+    constexpr iterator& operator-=(const std::ptrdiff_t diff);
 
-    iterator operator+(const std::ptrdiff_t diff) const;
-    iterator operator-(const std::ptrdiff_t diff) const;
+    constexpr iterator operator+(const std::ptrdiff_t diff) const;
+    constexpr iterator operator-(const std::ptrdiff_t diff) const;
 
-    std::ptrdiff_t operator-(const iterator& it) const;
+    constexpr std::ptrdiff_t operator-(const iterator& it) const;
 
-    T& operator[](const std::ptrdiff_t diff) const;
+    constexpr T& operator[](const std::ptrdiff_t diff) const;
 
    private:
     T* ptr_;
@@ -53,8 +63,8 @@ class Vector : public Memory<T> {
   class const_iterator
       : public std::iterator<std::random_access_iterator_tag, T> {
    public:
-    const_iterator();
-    const_iterator(const T* ptr);
+    constexpr const_iterator();
+    constexpr const_iterator(const T* ptr);
     const_iterator(const_iterator&& it) = default;
     const_iterator(const const_iterator& it) = default;
 
@@ -63,80 +73,142 @@ class Vector : public Memory<T> {
     const_iterator& operator=(const_iterator&& it) = default;
     const_iterator& operator=(const const_iterator& it) = default;
 
-    bool operator==(const const_iterator& it) const;
-    bool operator!=(const const_iterator& it) const;
-    bool operator<(const const_iterator& it) const;
-    bool operator>(const const_iterator& it) const;
-    bool operator>=(const const_iterator& it) const;
-    bool operator<=(const const_iterator& it) const;
+    constexpr bool operator==(const const_iterator& it) const;
+    constexpr bool operator!=(const const_iterator& it) const;
+    constexpr bool operator<(const const_iterator& it) const;
+    constexpr bool operator>(const const_iterator& it) const;
+    constexpr bool operator>=(const const_iterator& it) const;
+    constexpr bool operator<=(const const_iterator& it) const;
 
-    const T& operator*() const;
+    constexpr const T& operator*() const;
 
-    const_iterator& operator++();
-    const_iterator operator++(int);
+    constexpr const_iterator& operator++();
+    constexpr const_iterator operator++(int);
 
-    const_iterator& operator--();
-    const_iterator operator--(int);
+    constexpr const_iterator& operator--();
+    constexpr const_iterator operator--(int);
 
-    const_iterator& operator+=(const std::ptrdiff_t diff);
-    const_iterator& operator-=(const std::ptrdiff_t diff);
+    constexpr const_iterator& operator+=(const std::ptrdiff_t diff);
+    constexpr const_iterator& operator-=(const std::ptrdiff_t diff);
 
-    const_iterator operator+(const std::ptrdiff_t diff) const;
-    const_iterator operator-(const std::ptrdiff_t diff) const;
+    constexpr const_iterator operator+(const std::ptrdiff_t diff) const;
+    constexpr const_iterator operator-(const std::ptrdiff_t diff) const;
 
-    std::ptrdiff_t operator-(const const_iterator& it) const;
+    constexpr std::ptrdiff_t operator-(const const_iterator& it) const;
 
-    const T& operator[](const std::ptrdiff_t diff) const;
+    constexpr const T& operator[](const std::ptrdiff_t diff) const;
 
    private:
     const T* ptr_;
   };
 
  public:
-  Vector();
+  constexpr Vector();
+
+  constexpr explicit Vector(const uint64_t size, T&& elem = T());
+
+  template <typename Resource>
+  explicit Vector(Resource* resource);
 
-  explicit Vector(const uint64_t size, T&& elem = T());
+  // Evaluates the whole expression in one pass over the elements.
+  template <LazyExpression Expression>
+  Vector(const Expression& expression);
 
-  Vector(const Vector<T, Memory>& vector);
-  Vector(Vector<T, Memory>&& vector);
+  constexpr Vector(const Vector<T, Memory>& vector);
+  constexpr Vector(Vector<T, Memory>&& vector);
 
   Vector<T, Memory>& operator=(const Vector<T, Memory>& vector);
   Vector<T, Memory>& operator=(Vector<T, Memory>&& vector);
 
-  ~Vector();
+  template <LazyExpression Expression>
+  Vector<T, Memory>& operator=(const Expression& expression);
 
-  bool empty() const;
-  uint64_t size() const;
-  uint64_t capacity() const;
+  constexpr ~Vector();
 
-  void reserve(const uint64_t new_capacity);
-  void resize(const uint64_t new_size, T&& value);
-  void shrink_to_fit();
+  constexpr bool empty() const;
+  constexpr uint64_t size() const;
+  constexpr uint64_t capacity() const;
 
-  void clear();
+  constexpr void reserve(const uint64_t new_capacity);
+  constexpr void resize(const uint64_t new_size, const T& value = T());
+  constexpr void shrink_to_fit();
 
-  void push_back(T&& element);
-  void pop_back();
+  constexpr void clear();
+
+  constexpr void push_back(T&& element);
+  constexpr void pop_back();
+
+  template <typename... Args>
+  constexpr T& emplace_back(Args&&... args);
+
+  template <typename... Args>
+  constexpr T& emplace(const uint64_t idx, Args&&... args);
+
+  // Bulk operations grow the storage at most once and construct the new
+  // elements in one batch.
+  constexpr void insert(const uint64_t idx, const T& element);
+  constexpr void insert(const uint64_t idx, T&& element);
+  constexpr void insert(const uint64_t idx, const uint64_t amount,
+                        const T& element);
+
+  template <std::input_iterator Iterator>
+  constexpr void insert(const uint64_t idx, Iterator first, Iterator last);
+
+  constexpr void erase(const uint64_t idx, const uint64_t amount = 1);
+
+  constexpr void assign(const uint64_t amount, const T& element);
+
+  template <std::input_iterator Iterator>
+  constexpr void assign(Iterator first, Iterator last);
+
+  template <std::ranges::input_range Range>
+  constexpr void append_range(Range&& range);
+
+  // Reads up to bytes bytes of raw elements from fd straight into the
+  // reserved tail. A partial element at the end of the file isn't appended,
+  // a seekable fd is moved back before its bytes so a later read sees them
+  // again, other fds lose them. Returns false on a read error, the elements
+  // read before it are kept.
+  bool append_from_fd(const int fd, const uint64_t bytes);
+
+  constexpr T& at(const uint64_t idx);
+  constexpr const T& at(const uint64_t idx) const;
 
-  T& at(const uint64_t idx);
-  const T& at(const uint64_t idx) const;
+  constexpr T& operator[](const uint64_t idx);
+  constexpr const T& operator[](const uint64_t idx) const;
 
-  T& operator[](const uint64_t idx);
-  const T& operator[](const uint64_t idx) const;
+  constexpr T& front();
+  constexpr const T& front() const;
 
-  T& front();
-  const T& front() const;
+  constexpr T& back();
+  constexpr const T& back() const;
 
-  T& back();
-  const T& back() const;
+  constexpr iterator begin();
+  constexpr iterator end();
 
-  iterator begin();
-  iterator end();
+  constexpr const_iterator cbegin() const;
+  constexpr const_iterator cend() const;
 
-  const_iterator cbegin() const;
-  const_iterator cend() const;
+  VectorView<T> subview(const uint64_t offset, const uint64_t length) const;
 
  private:
+  // Memory policies with inline storage can't grow past their MaxCapacity.
+  static constexpr uint64_t ClampCapacity(const uint64_t capacity);
+
+  // Moves the elements from idx on by amount positions to the right and
+  // leaves [idx, idx + amount) uninitialized, the size isn't changed.
+  constexpr void OpenGap(const uint64_t idx, const uint64_t amount);
+
+  template <typename Iterator>
+  constexpr void ConstructRange(const uint64_t from, Iterator first,
+                                const uint64_t amount);
+
+  // Inserts amount elements of a forward range, which may be a range of
+  // this vector's own elements.
+  template <typename Iterator>
+  constexpr void InsertRange(const uint64_t idx, Iterator first,
+                             const uint64_t amount);
+
   const static uint64_t base_capacity = 8;
   const static uint64_t base_capacity_multiplier_ = 2;
 
@@ -292,12 +364,19 @@ class Vector<bool> {
 
   explicit Vector(const uint64_t size, bool elem);
 
+  // Packs a comparison expression into bits without a temporary.
+  template <LazyExpression Expression>
+  Vector(const Expression& expression);
+
   Vector(const Vector<bool>& vector);
   Vector(Vector<bool>&& vector);
 
   Vector<bool>& operator=(const Vector<bool>& vector);
   Vector<bool>& operator=(Vector<bool>&& vector);
 
+  template <LazyExpression Expression>
+  Vector<bool>& operator=(const Expression& expression);
+
   ~Vector();
 
   bool empty() const;
@@ -331,10 +410,15 @@ class Vector<bool> {
   const_bit_iterator cbegin() const;
   const_bit_iterator cend() const;
 
+  BitView subview(const uint64_t offset, const uint64_t length) const;
+
  private:
   static uint64_t GetBitIdx(const uint64_t bit_number);
   static uint64_t GetBitSize(const uint64_t bits_amount);
 
+  template <typename Expression>
+  void PackExpression(const Expression& expression);
+
   const static uint8_t bit_divider = 64;
   const static uint64_t base_capacity = 64;
   const static uint64_t base_capacity_multiplier_ = 2;
@@ -346,102 +430,110 @@ class Vector<bool> {
 };
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator::iterator() : ptr_(nullptr) {}
+constexpr Vector<T, Memory>::iterator::iterator() : ptr_(nullptr) {}
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator::const_iterator() : ptr_(nullptr) {}
+constexpr Vector<T, Memory>::const_iterator::const_iterator() : ptr_(nullptr) {}
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator::iterator(T* ptr) : ptr_(ptr) {}
+constexpr Vector<T, Memory>::iterator::iterator(T* ptr) : ptr_(ptr) {}
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator::const_iterator(const T* ptr) : ptr_(ptr) {}
+constexpr Vector<T, Memory>::const_iterator::const_iterator(const T* ptr)
+    : ptr_(ptr) {}
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::iterator::operator==(const iterator& it) const {
+constexpr bool Vector<T, Memory>::iterator::operator==(
+    const iterator& it) const {
   return ptr_ == it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::const_iterator::operator==(
+constexpr bool Vector<T, Memory>::const_iterator::operator==(
     const const_iterator& it) const {
   return ptr_ == it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::iterator::operator!=(const iterator& it) const {
+constexpr bool Vector<T, Memory>::iterator::operator!=(
+    const iterator& it) const {
   return ptr_ != it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::const_iterator::operator!=(
+constexpr bool Vector<T, Memory>::const_iterator::operator!=(
     const const_iterator& it) const {
   return ptr_ != it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::iterator::operator<(const iterator& it) const {
+constexpr bool Vector<T, Memory>::iterator::operator<(
+    const iterator& it) const {
   return ptr_ < it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::const_iterator::operator<(
+constexpr bool Vector<T, Memory>::const_iterator::operator<(
     const const_iterator& it) const {
   return ptr_ < it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::iterator::operator>(const iterator& it) const {
+constexpr bool Vector<T, Memory>::iterator::operator>(
+    const iterator& it) const {
   return ptr_ > it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::const_iterator::operator>(
+constexpr bool Vector<T, Memory>::const_iterator::operator>(
     const const_iterator& it) const {
   return ptr_ > it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::iterator::operator>=(const iterator& it) const {
+constexpr bool Vector<T, Memory>::iterator::operator>=(
+    const iterator& it) const {
   return ptr_ >= it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::const_iterator::operator>=(
+constexpr bool Vector<T, Memory>::const_iterator::operator>=(
     const const_iterator& it) const {
   return ptr_ >= it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::iterator::operator<=(const iterator& it) const {
+constexpr bool Vector<T, Memory>::iterator::operator<=(
+    const iterator& it) const {
   return ptr_ <= it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::const_iterator::operator<=(
+constexpr bool Vector<T, Memory>::const_iterator::operator<=(
     const const_iterator& it) const {
   return ptr_ <= it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-T& Vector<T, Memory>::iterator::operator*() const {
+constexpr T& Vector<T, Memory>::iterator::operator*() const {
   return *ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-const T& Vector<T, Memory>::const_iterator::operator*() const {
+constexpr const T& Vector<T, Memory>::const_iterator::operator*() const {
   return *ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator++() {
+constexpr Vector<T, Memory>::iterator&
+Vector<T, Memory>::iterator::operator++() {
   ++ptr_;
 
   return *this;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator&
+constexpr Vector<T, Memory>::const_iterator&
 Vector<T, Memory>::const_iterator::operator++() {
   ++ptr_;
 
@@ -449,29 +541,33 @@ Vector<T, Memory>::const_iterator::operator++() {
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator++(int) {
+constexpr Vector<T, Memory>::iterator
+Vector<T, Memory>::iterator::operator++(int) {
+  iterator saved_it = *this;
   ptr_++;
 
-  return *this;
+  return saved_it;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator Vector<T, Memory>::const_iterator::operator++(
-    int) {
+constexpr Vector<T, Memory>::const_iterator
+Vector<T, Memory>::const_iterator::operator++(int) {
+  const_iterator saved_it = *this;
   ptr_++;
 
-  return *this;
+  return saved_it;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator--() {
+constexpr Vector<T, Memory>::iterator&
+Vector<T, Memory>::iterator::operator--() {
   --ptr_;
 
   return *this;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator&
+constexpr Vector<T, Memory>::const_iterator&
 Vector<T, Memory>::const_iterator::operator--() {
   --ptr_;
 
@@ -479,22 +575,25 @@ Vector<T, Memory>::const_iterator::operator--() {
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator--(int) {
+constexpr Vector<T, Memory>::iterator
+Vector<T, Memory>::iterator::operator--(int) {
+  iterator saved_it = *this;
   ptr_--;
 
-  return *this;
+  return saved_it;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator Vector<T, Memory>::const_iterator::operator--(
-    int) {
+constexpr Vector<T, Memory>::const_iterator
+Vector<T, Memory>::const_iterator::operator--(int) {
+  const_iterator saved_it = *this;
   ptr_--;
 
-  return *this;
+  return saved_it;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator+=(
+constexpr Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator+=(
     const std::ptrdiff_t diff) {
   ptr_ += diff;
 
@@ -502,7 +601,7 @@ Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator+=(
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator&
+constexpr Vector<T, Memory>::const_iterator&
 Vector<T, Memory>::const_iterator::operator+=(const std::ptrdiff_t diff) {
   ptr_ += diff;
 
@@ -510,7 +609,7 @@ Vector<T, Memory>::const_iterator::operator+=(const std::ptrdiff_t diff) {
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator-=(
+constexpr Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator-=(
     const std::ptrdiff_t diff) {
   ptr_ -= diff;
 
@@ -518,7 +617,7 @@ Vector<T, Memory>::iterator& Vector<T, Memory>::iterator::operator-=(
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator&
+constexpr Vector<T, Memory>::const_iterator&
 Vector<T, Memory>::const_iterator::operator-=(const std::ptrdiff_t diff) {
   ptr_ -= diff;
 
@@ -526,7 +625,7 @@ Vector<T, Memory>::const_iterator::operator-=(const std::ptrdiff_t diff) {
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator+(
+constexpr Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator+(
     const std::ptrdiff_t diff) const {
   iterator temp = *this;
   temp += diff;
@@ -535,8 +634,8 @@ Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator+(
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator Vector<T, Memory>::const_iterator::operator+(
-    const std::ptrdiff_t diff) const {
+constexpr Vector<T, Memory>::const_iterator
+Vector<T, Memory>::const_iterator::operator+(const std::ptrdiff_t diff) const {
   const_iterator temp = *this;
   temp += diff;
 
@@ -544,7 +643,7 @@ Vector<T, Memory>::const_iterator Vector<T, Memory>::const_iterator::operator+(
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator-(
+constexpr Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator-(
     const std::ptrdiff_t diff) const {
   iterator temp = *this;
   temp -= diff;
@@ -553,8 +652,8 @@ Vector<T, Memory>::iterator Vector<T, Memory>::iterator::operator-(
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator Vector<T, Memory>::const_iterator::operator-(
-    const std::ptrdiff_t diff) const {
+constexpr Vector<T, Memory>::const_iterator
+Vector<T, Memory>::const_iterator::operator-(const std::ptrdiff_t diff) const {
   const_iterator temp = *this;
   temp -= diff;
 
@@ -562,41 +661,66 @@ Vector<T, Memory>::const_iterator Vector<T, Memory>::const_iterator::operator-(
 }
 
 template <typename T, template <typename> class Memory>
-std::ptrdiff_t Vector<T, Memory>::iterator::operator-(
+constexpr std::ptrdiff_t Vector<T, Memory>::iterator::operator-(
     const iterator& it) const {
   return ptr_ - it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-std::ptrdiff_t Vector<T, Memory>::const_iterator::operator-(
+constexpr std::ptrdiff_t Vector<T, Memory>::const_iterator::operator-(
     const const_iterator& it) const {
   return ptr_ - it.ptr_;
 }
 
 template <typename T, template <typename> class Memory>
-T& Vector<T, Memory>::iterator::operator[](const std::ptrdiff_t diff) const {
+constexpr T& Vector<T, Memory>::iterator::operator[](
+    const std::ptrdiff_t diff) const {
   return ptr_[diff];
 }
 
 template <typename T, template <typename> class Memory>
-const T& Vector<T, Memory>::const_iterator::operator[](
+constexpr const T& Vector<T, Memory>::const_iterator::operator[](
     const std::ptrdiff_t diff) const {
   return ptr_[diff];
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::Vector() : Memory<T>(0), size_(0), capacity_(0) {}
+constexpr Vector<T, Memory>::Vector() : Memory<T>(0), size_(0), capacity_(0) {}
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::Vector(const uint64_t size, T&& elem)
-    : Memory<T>(size),
+constexpr Vector<T, Memory>::Vector(const uint64_t size, T&& elem)
+    : Memory<T>(ClampCapacity(base_capacity_multiplier_ * size)),
       size_(size),
-      capacity_(base_capacity_multiplier_ * size) {
+      capacity_(ClampCapacity(base_capacity_multiplier_ * size)) {
+  assert(size_ <= capacity_);
+
   Construct(this->data(), 0, size_, elem);
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::Vector(const Vector<T, Memory>& vector)
+template <typename Resource>
+Vector<T, Memory>::Vector(Resource* resource)
+    : Memory<T>(0, resource), size_(0), capacity_(0) {}
+
+template <typename T, template <typename> class Memory>
+template <LazyExpression Expression>
+Vector<T, Memory>::Vector(const Expression& expression)
+    : Memory<T>(expression.size()),
+      size_(expression.size()),
+      capacity_(expression.size()) {
+  T* data = this->data();
+
+  ForEachChunk<T, std::is_trivially_copyable_v<T>>(
+      0, size_,
+      [data, &expression](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          new (data + cur_idx) T(static_cast<T>(expression[cur_idx]));
+        }
+      });
+}
+
+template <typename T, template <typename> class Memory>
+constexpr Vector<T, Memory>::Vector(const Vector<T, Memory>& vector)
     : Memory<T>(vector.capacity_),
       size_(vector.size_),
       capacity_(vector.capacity_) {
@@ -604,14 +728,18 @@ Vector<T, Memory>::Vector(const Vector<T, Memory>& vector)
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::Vector(Vector<T, Memory>&& vector)
-    : Memory<T>(std::forward<decltype(vector)>(vector)),
-      size_(vector.size_),
-      capacity_(vector.capacity_) {}
+constexpr Vector<T, Memory>::Vector(Vector<T, Memory>&& vector)
+    : Memory<T>(std::move(vector)),
+      size_(std::exchange(vector.size_, 0)),
+      capacity_(std::exchange(vector.capacity_, 0)) {}
 
 template <typename T, template <typename> class Memory>
 Vector<T, Memory>& Vector<T, Memory>::operator=(
     const Vector<T, Memory>& vector) {
+  if (this == &vector) {
+    return *this;
+  }
+
   if (vector.size_ < size_) {
     Assign(this->data(), 0, vector.size_, vector.data());
     Destruct(this->data(), vector.size_, size_);
@@ -623,16 +751,52 @@ Vector<T, Memory>& Vector<T, Memory>::operator=(
   }
 
   size_ = vector.size_;
+
+  return *this;
 }
 
+// The storage is handed over by the memory policy, the other vector gets
+// this one's storage back with no elements in it.
 template <typename T, template <typename> class Memory>
 Vector<T, Memory>& Vector<T, Memory>::operator=(Vector<T, Memory>&& vector) {
-  ~Vector();
-  Vector(std::forward<Vector<T, Memory>>(vector));
+  if (this == &vector) {
+    return *this;
+  }
+
+  Destruct(this->data(), 0, size_);
+
+  Memory<T>::operator=(std::move(vector));
+
+  size_ = std::exchange(vector.size_, 0);
+  std::swap(capacity_, vector.capacity_);
+
+  return *this;
+}
+
+// A vector used inside the expression already has its size, so it is never
+// reallocated before being read.
+template <typename T, template <typename> class Memory>
+template <LazyExpression Expression>
+Vector<T, Memory>& Vector<T, Memory>::operator=(const Expression& expression) {
+  if (expression.size() != size_) {
+    resize(expression.size(), T());
+  }
+
+  T* data = this->data();
+
+  ForEachChunk<T, std::is_trivially_copyable_v<T>>(
+      0, size_,
+      [data, &expression](const uint64_t chunk_from, const uint64_t chunk_to) {
+        for (uint64_t cur_idx = chunk_from; cur_idx < chunk_to; cur_idx++) {
+          data[cur_idx] = static_cast<T>(expression[cur_idx]);
+        }
+      });
+
+  return *this;
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::~Vector() {
+constexpr Vector<T, Memory>::~Vector() {
   if (this->data()) {
     Destruct(this->data(), 0, size_);
   }
@@ -642,34 +806,38 @@ Vector<T, Memory>::~Vector() {
 }
 
 template <typename T, template <typename> class Memory>
-bool Vector<T, Memory>::empty() const {
+constexpr bool Vector<T, Memory>::empty() const {
   return (size_ == 0);
 }
 
 template <typename T, template <typename> class Memory>
-uint64_t Vector<T, Memory>::size() const {
+constexpr uint64_t Vector<T, Memory>::size() const {
   return size_;
 }
 
 template <typename T, template <typename> class Memory>
-uint64_t Vector<T, Memory>::capacity() const {
+constexpr uint64_t Vector<T, Memory>::capacity() const {
   return capacity_;
 }
 
 template <typename T, template <typename> class Memory>
-void Vector<T, Memory>::reserve(uint64_t new_capacity) {
+constexpr void Vector<T, Memory>::reserve(uint64_t new_capacity) {
   if (new_capacity <= capacity_) {
     return;
   }
 
-  new_capacity = std::max(new_capacity, capacity_ * base_capacity_multiplier_);
+  assert(new_capacity <= ClampCapacity(new_capacity));
+
+  new_capacity = ClampCapacity(
+      std::max(new_capacity, capacity_ * base_capacity_multiplier_));
 
   this->Realloc(size_, new_capacity);
   capacity_ = new_capacity;
 }
 
 template <typename T, template <typename> class Memory>
-void Vector<T, Memory>::resize(const uint64_t new_size, T&& elem) {
+constexpr void Vector<T, Memory>::resize(const uint64_t new_size,
+                                         const T& elem) {
   if (new_size < size_) {
     Destruct(this->data(), new_size, size_);
   } else {
@@ -682,7 +850,7 @@ void Vector<T, Memory>::resize(const uint64_t new_size, T&& elem) {
 }
 
 template <typename T, template <typename> class Memory>
-void Vector<T, Memory>::shrink_to_fit() {
+constexpr void Vector<T, Memory>::shrink_to_fit() {
   if (size_ == capacity_) {
     return;
   }
@@ -692,97 +860,381 @@ void Vector<T, Memory>::shrink_to_fit() {
 }
 
 template <typename T, template <typename> class Memory>
-void Vector<T, Memory>::clear() {
+constexpr void Vector<T, Memory>::clear() {
   Destruct(this->data(), 0, size_);
   size_ = 0;
 }
 
 template <typename T, template <typename> class Memory>
-void Vector<T, Memory>::push_back(T&& element) {
-  if (capacity_ == 0) {
-    reserve(base_capacity);
+constexpr void Vector<T, Memory>::push_back(T&& element) {
+  emplace_back(std::forward<T>(element));
+}
+
+template <typename T, template <typename> class Memory>
+constexpr void Vector<T, Memory>::pop_back() {
+  assert(size_);
+
+  std::destroy_at(this->data() + --size_);
+}
+
+// The arguments may refer to an element, so on growth the new element is
+// built before the storage moves.
+template <typename T, template <typename> class Memory>
+template <typename... Args>
+constexpr T& Vector<T, Memory>::emplace_back(Args&&... args) {
+  if (size_ < capacity_) {
+    std::construct_at(this->data() + size_, std::forward<Args>(args)...);
   } else {
-    reserve(size_ + 1);
+    T element(std::forward<Args>(args)...);
+
+    reserve((capacity_ == 0) ? base_capacity : size_ + 1);
+
+    std::construct_at(this->data() + size_, std::move(element));
   }
 
-  this->data()[size_++] = std::forward<T>(element);
+  return this->data()[size_++];
 }
 
 template <typename T, template <typename> class Memory>
-void Vector<T, Memory>::pop_back() {
-  assert(size_);
+template <typename... Args>
+constexpr T& Vector<T, Memory>::emplace(const uint64_t idx, Args&&... args) {
+  assert(idx <= size_);
+
+  T element(std::forward<Args>(args)...);
+
+  OpenGap(idx, 1);
+  std::construct_at(this->data() + idx, std::move(element));
+  size_++;
 
-  this->data()[--size_].~T();
+  return this->data()[idx];
+}
+
+template <typename T, template <typename> class Memory>
+constexpr void Vector<T, Memory>::insert(const uint64_t idx,
+                                         const T& element) {
+  emplace(idx, element);
+}
+
+template <typename T, template <typename> class Memory>
+constexpr void Vector<T, Memory>::insert(const uint64_t idx, T&& element) {
+  emplace(idx, std::forward<T>(element));
+}
+
+template <typename T, template <typename> class Memory>
+constexpr void Vector<T, Memory>::insert(const uint64_t idx,
+                                         const uint64_t amount,
+                                         const T& element) {
+  assert(idx <= size_);
+
+  T copy(element);
+
+  OpenGap(idx, amount);
+  Construct(this->data(), idx, idx + amount, copy);
+  size_ += amount;
 }
 
+// Single pass ranges are appended one by one and rotated into place, as
+// their length isn't known up front.
 template <typename T, template <typename> class Memory>
-T& Vector<T, Memory>::at(const uint64_t idx) {
+template <std::input_iterator Iterator>
+constexpr void Vector<T, Memory>::insert(const uint64_t idx, Iterator first,
+                                         Iterator last) {
+  assert(idx <= size_);
+
+  if constexpr (std::forward_iterator<Iterator>) {
+    InsertRange(idx, first,
+                static_cast<uint64_t>(std::distance(first, last)));
+  } else {
+    uint64_t old_size = size_;
+
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+
+    std::rotate(this->data() + idx, this->data() + old_size,
+                this->data() + size_);
+  }
+}
+
+template <typename T, template <typename> class Memory>
+constexpr void Vector<T, Memory>::erase(const uint64_t idx,
+                                        const uint64_t amount) {
+  assert(idx + amount <= size_);
+
+  T* data = this->data();
+
+  std::move(data + idx + amount, data + size_, data + idx);
+  Destruct(data, size_ - amount, size_);
+
+  size_ -= amount;
+}
+
+template <typename T, template <typename> class Memory>
+constexpr void Vector<T, Memory>::assign(const uint64_t amount,
+                                         const T& element) {
+  T copy(element);
+
+  clear();
+  reserve(amount);
+
+  Construct(this->data(), 0, amount, copy);
+  size_ = amount;
+}
+
+template <typename T, template <typename> class Memory>
+template <std::input_iterator Iterator>
+constexpr void Vector<T, Memory>::assign(Iterator first, Iterator last) {
+  clear();
+  append_range(std::ranges::subrange(first, last));
+}
+
+template <typename T, template <typename> class Memory>
+template <std::ranges::input_range Range>
+constexpr void Vector<T, Memory>::append_range(Range&& range) {
+  if constexpr (std::ranges::forward_range<Range>) {
+    InsertRange(size_, std::ranges::begin(range),
+                static_cast<uint64_t>(std::ranges::distance(range)));
+  } else {
+    for (auto&& element : range) {
+      emplace_back(std::forward<decltype(element)>(element));
+    }
+  }
+}
+
+template <typename T, template <typename> class Memory>
+bool Vector<T, Memory>::append_from_fd(const int fd, const uint64_t bytes) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Elements are read from the file as raw bytes");
+
+  reserve(size_ + bytes / sizeof(T));
+
+  uint64_t read_bytes = 0;
+  bool is_read = ReadFully(fd, reinterpret_cast<char*>(this->data() + size_),
+                           bytes - bytes % sizeof(T), read_bytes);
+
+  size_ += read_bytes / sizeof(T);
+
+  if ((read_bytes % sizeof(T)) != 0) {
+    SeekBack(fd, read_bytes % sizeof(T));
+  }
+
+  return is_read;
+}
+
+template <typename T, template <typename> class Memory>
+constexpr T& Vector<T, Memory>::at(const uint64_t idx) {
   assert(idx < size_);
 
   return this->data()[idx];
 }
 
 template <typename T, template <typename> class Memory>
-const T& Vector<T, Memory>::at(const uint64_t idx) const {
+constexpr const T& Vector<T, Memory>::at(const uint64_t idx) const {
   assert(idx < size_);
 
   return this->data()[idx];
 }
 
 template <typename T, template <typename> class Memory>
-T& Vector<T, Memory>::operator[](const uint64_t idx) {
+constexpr T& Vector<T, Memory>::operator[](const uint64_t idx) {
   return this->data()[idx];
 }
 
 template <typename T, template <typename> class Memory>
-const T& Vector<T, Memory>::operator[](const uint64_t idx) const {
+constexpr const T& Vector<T, Memory>::operator[](const uint64_t idx) const {
   return this->data()[idx];
 }
 
 template <typename T, template <typename> class Memory>
-T& Vector<T, Memory>::front() {
+constexpr T& Vector<T, Memory>::front() {
   assert(size_);
 
   return this->data()[0];
 }
 
 template <typename T, template <typename> class Memory>
-const T& Vector<T, Memory>::front() const {
+constexpr const T& Vector<T, Memory>::front() const {
   assert(size_);
 
   return this->data()[0];
 }
 
 template <typename T, template <typename> class Memory>
-T& Vector<T, Memory>::back() {
+constexpr T& Vector<T, Memory>::back() {
   assert(size_);
 
   return this->data()[size_ - 1];
 }
 
 template <typename T, template <typename> class Memory>
-const T& Vector<T, Memory>::back() const {
+constexpr const T& Vector<T, Memory>::back() const {
   assert(size_);
 
   return this->data()[size_ - 1];
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator Vector<T, Memory>::begin() {
+constexpr Vector<T, Memory>::iterator Vector<T, Memory>::begin() {
   return {this->data()};
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::iterator Vector<T, Memory>::end() {
+constexpr Vector<T, Memory>::iterator Vector<T, Memory>::end() {
   return {this->data() + size_};
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator Vector<T, Memory>::cbegin() const {
+constexpr Vector<T, Memory>::const_iterator Vector<T, Memory>::cbegin() const {
   return {this->data()};
 }
 
 template <typename T, template <typename> class Memory>
-Vector<T, Memory>::const_iterator Vector<T, Memory>::cend() const {
+constexpr Vector<T, Memory>::const_iterator Vector<T, Memory>::cend() const {
   return {this->data() + size_};
 }
+
+template <typename T, template <typename> class Memory>
+constexpr uint64_t Vector<T, Memory>::ClampCapacity(const uint64_t capacity) {
+  if constexpr (requires { Memory<T>::MaxCapacity; }) {
+    return std::min(capacity, Memory<T>::MaxCapacity);
+  } else {
+    return capacity;
+  }
+}
+
+template <typename T, template <typename> class Memory>
+constexpr void Vector<T, Memory>::OpenGap(const uint64_t idx,
+                                          const uint64_t amount) {
+  reserve(size_ + amount);
+
+  T* data = this->data();
+
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    if (!std::is_constant_evaluated()) {
+      if (idx != size_) {
+        std::memmove(static_cast<void*>(data + idx + amount), data + idx,
+                     (size_ - idx) * sizeof(T));
+      }
+
+      return;
+    }
+  }
+
+  for (uint64_t cur_idx = size_; cur_idx > idx; cur_idx--) {
+    std::construct_at(data + cur_idx - 1 + amount,
+                      std::move(data[cur_idx - 1]));
+    std::destroy_at(data + cur_idx - 1);
+  }
+}
+
+// Contiguous ranges of T go through the batch construct helper.
+template <typename T, template <typename> class Memory>
+template <typename Iterator>
+constexpr void Vector<T, Memory>::ConstructRange(const uint64_t from,
+                                                 Iterator first,
+                                                 const uint64_t amount) {
+  if constexpr (std::contiguous_iterator<Iterator> &&
+                std::is_same_v<std::iter_value_t<Iterator>, T>) {
+    Construct<T>(this->data() + from, 0, amount, std::to_address(first));
+  } else {
+    T* data = this->data();
+
+    for (uint64_t cur_idx = from; cur_idx < from + amount; cur_idx++) {
+      std::construct_at(data + cur_idx, *first);
+      ++first;
+    }
+  }
+}
+
+// A range of own elements would move or be freed under the gap, so it is
+// copied into a temporary buffer first. Addresses of unrelated objects can't
+// be ordered during constant evaluation, so there the copy is always made.
+template <typename T, template <typename> class Memory>
+template <typename Iterator>
+constexpr void Vector<T, Memory>::InsertRange(const uint64_t idx,
+                                              Iterator first,
+                                              const uint64_t amount) {
+  using Reference = std::iter_reference_t<Iterator>;
+
+  if constexpr (std::is_lvalue_reference_v<Reference> &&
+                std::is_same_v<std::remove_cvref_t<Reference>, T>) {
+    std::less<const T*> less;
+
+    if ((amount != 0) &&
+        (std::is_constant_evaluated() ||
+         (!less(std::addressof(*first), this->data()) &&
+          less(std::addressof(*first), this->data() + size_)))) {
+      std::allocator<T> allocator;
+      T* copy = allocator.allocate(amount);
+
+      for (uint64_t cur_idx = 0; cur_idx < amount; cur_idx++) {
+        std::construct_at(copy + cur_idx, *first);
+        ++first;
+      }
+
+      OpenGap(idx, amount);
+      MoveConstruct(this->data() + idx, 0, amount, copy);
+      size_ += amount;
+
+      Destruct(copy, 0, amount);
+      allocator.deallocate(copy, amount);
+
+      return;
+    }
+  }
+
+  OpenGap(idx, amount);
+  ConstructRange(idx, first, amount);
+  size_ += amount;
+}
+
+template <typename T, template <typename> class Memory>
+VectorView<T> Vector<T, Memory>::subview(const uint64_t offset,
+                                         const uint64_t length) const {
+  assert(offset + length <= size_);
+
+  return {this->data() + offset, length};
+}
+
+template <LazyExpression Expression>
+Vector<bool>::Vector(const Expression& expression)
+    : size_(expression.size()),
+      capacity_(expression.size()),
+      data_(new uint64_t[GetBitSize(capacity_)]()) {
+  PackExpression(expression);
+}
+
+template <LazyExpression Expression>
+Vector<bool>& Vector<bool>::operator=(const Expression& expression) {
+  reserve(expression.size());
+  size_ = expression.size();
+
+  PackExpression(expression);
+
+  return *this;
+}
+
+template <typename Expression>
+void Vector<bool>::PackExpression(const Expression& expression) {
+  uint64_t* data = data_;
+  uint64_t size = size_;
+
+  ForEachChunk<uint64_t, true>(
+      0, GetBitSize(size_),
+      [data, size, &expression](const uint64_t chunk_from,
+                                const uint64_t chunk_to) {
+        for (uint64_t word_idx = chunk_from; word_idx < chunk_to; word_idx++) {
+          uint64_t bits_from = word_idx * bit_divider;
+          uint64_t bits_to = std::min(size, bits_from + bit_divider);
+          uint64_t word = 0;
+
+          for (uint64_t bit_idx = bits_from; bit_idx < bits_to; bit_idx++) {
+            word |= static_cast<uint64_t>(static_cast<bool>(
+                        expression[bit_idx]))
+                    << (bit_idx - bits_from);
+          }
+
+          data[word_idx] = word;
+        }
+      });
+}
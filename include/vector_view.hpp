@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+template <typename T, template <typename> class Memory>
+class Vector;
+
+// Non-owning read-only view over contiguous elements. Views don't keep the
+// viewed vector alive and are invalidated by its reallocation.
+template <typename T>
+class VectorView {
+ public:
+  VectorView();
+  VectorView(const T* data, const uint64_t size);
+
+  template <template <typename> class Memory>
+  VectorView(const Vector<T, Memory>& vector);
+
+  VectorView(const VectorView& view) = default;
+  VectorView(VectorView&& view) = default;
+
+  VectorView& operator=(const VectorView& view) = default;
+  VectorView& operator=(VectorView&& view) = default;
+
+  ~VectorView() = default;
+
+  bool empty() const;
+  uint64_t size() const;
+
+  const T* data() const;
+
+  const T& at(const uint64_t idx) const;
+  const T& operator[](const uint64_t idx) const;
+
+  const T& front() const;
+  const T& back() const;
+
+  const T* begin() const;
+  const T* end() const;
+
+  VectorView subview(const uint64_t offset, const uint64_t length) const;
+
+ private:
+  const T* data_;
+  uint64_t size_;
+};
+
+// Non-owning read-only view over a bit range, which doesn't have to start
+// on a word boundary.
+class BitView {
+ public:
+  BitView();
+  BitView(const uint64_t* data, const uint64_t offset, const uint64_t size);
+
+  BitView(const BitView& view) = default;
+  BitView(BitView&& view) = default;
+
+  BitView& operator=(const BitView& view) = default;
+  BitView& operator=(BitView&& view) = default;
+
+  ~BitView() = default;
+
+  bool empty() const;
+  uint64_t size() const;
+
+  // The first word and the bit offset of the view inside it.
+  const uint64_t* data() const;
+  uint64_t offset() const;
+
+  bool at(const uint64_t idx) const;
+  bool operator[](const uint64_t idx) const;
+
+  BitView subview(const uint64_t offset, const uint64_t length) const;
+
+ private:
+  static constexpr uint64_t WordBits = 64;
+
+  const uint64_t* data_;
+  uint64_t offset_;
+  uint64_t size_;
+};
+
+// Word at a time popcount and search. Find returns size when nothing
+// matches.
+uint64_t Count(const BitView view, const bool value);
+uint64_t Find(const BitView view, const bool value);
+bool Contains(const BitView view, const bool value);
+
+template <typename T>
+VectorView<T>::VectorView() : data_(nullptr), size_(0) {}
+
+template <typename T>
+VectorView<T>::VectorView(const T* data, const uint64_t size)
+    : data_(data), size_(size) {}
+
+template <typename T>
+template <template <typename> class Memory>
+VectorView<T>::VectorView(const Vector<T, Memory>& vector)
+    : data_(vector.data()), size_(vector.size()) {}
+
+template <typename T>
+bool VectorView<T>::empty() const {
+  return (size_ == 0);
+}
+
+template <typename T>
+uint64_t VectorView<T>::size() const {
+  return size_;
+}
+
+template <typename T>
+const T* VectorView<T>::data() const {
+  return data_;
+}
+
+template <typename T>
+const T& VectorView<T>::at(const uint64_t idx) const {
+  assert(idx < size_);
+
+  return data_[idx];
+}
+
+template <typename T>
+const T& VectorView<T>::operator[](const uint64_t idx) const {
+  return data_[idx];
+}
+
+template <typename T>
+const T& VectorView<T>::front() const {
+  assert(size_);
+
+  return data_[0];
+}
+
+template <typename T>
+const T& VectorView<T>::back() const {
+  assert(size_);
+
+  return data_[size_ - 1];
+}
+
+template <typename T>
+const T* VectorView<T>::begin() const {
+  return data_;
+}
+
+template <typename T>
+const T* VectorView<T>::end() const {
+  return data_ + size_;
+}
+
+template <typename T>
+VectorView<T> VectorView<T>::subview(const uint64_t offset,
+                                     const uint64_t length) const {
+  assert(offset + length <= size_);
+
+  return {data_ + offset, length};
+}
@@ -559,3 +559,10 @@ Vector<bool>::const_bit_iterator Vector<bool>::cbegin() const {
 Vector<bool>::const_bit_iterator Vector<bool>::cend() const {
   return {data_ + GetBitIdx(size_), size_ % bit_divider};
 }
+
+BitView Vector<bool>::subview(const uint64_t offset,
+                              const uint64_t length) const {
+  assert(offset + length <= size_);
+
+  return {data_, offset, length};
+}
@@ -0,0 +1,276 @@
+#include "../include/file_loader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "../include/os_memory.hpp"
+
+// The chunk size is rounded up to whole pages, so every window after the
+// first one starts at a page aligned offset.
+FileLoader::FileLoader(const int fd, const uint64_t chunk_size)
+    : fd_(fd),
+      chunk_size_((std::max<uint64_t>(chunk_size, 1) + GetOsPageSize() - 1) &
+                  ~(GetOsPageSize() - 1)),
+      is_mapped_(false),
+      file_end_(0),
+      window_offset_(0),
+      window_skip_(0),
+      window_(nullptr),
+      window_size_(0),
+      parsed_window_(nullptr),
+      parsed_window_size_(0),
+      buffers_{nullptr, nullptr},
+      buffer_sizes_{0, 0},
+      is_buffer_ready_{false, false},
+      parsed_buffer_(0),
+      is_holding_buffer_(false),
+      is_read_finished_(false),
+      is_stopped_(false),
+      is_failed_(false),
+      mutex_(),
+      cv_(),
+      reader_(),
+      chunk_(),
+      chunk_pos_(0),
+      carry_() {
+  struct stat file_stat = {};
+  off_t position = lseek(fd_, 0, SEEK_CUR);
+
+  // Some special files report a zero size while having contents, so they
+  // are read instead.
+  if ((position >= 0) && (fstat(fd_, &file_stat) == 0) &&
+      S_ISREG(file_stat.st_mode) && (file_stat.st_size > 0)) {
+    file_end_ = static_cast<uint64_t>(file_stat.st_size);
+    window_offset_ = static_cast<uint64_t>(position) & ~(GetOsPageSize() - 1);
+    window_skip_ = static_cast<uint64_t>(position) - window_offset_;
+
+    posix_fadvise(fd_, position, 0, POSIX_FADV_SEQUENTIAL);
+
+    is_mapped_ = (window_offset_ >= file_end_) || MapWindow();
+  }
+
+  if (!is_mapped_) {
+    StartReader();
+  }
+}
+
+FileLoader::~FileLoader() {
+  if (reader_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_stopped_ = true;
+    }
+
+    cv_.notify_all();
+    reader_.join();
+  }
+
+  delete[] buffers_[0];
+  delete[] buffers_[1];
+
+  // Windows are mapped without moving the descriptor, so it is moved past
+  // the handed out chunks, minus the unparsed rest of the record chunk.
+  if (is_mapped_) {
+    lseek(fd_,
+          static_cast<off_t>(window_offset_ + window_skip_ -
+                             (chunk_.size() - chunk_pos_)),
+          SEEK_SET);
+  }
+
+  if (window_ != nullptr) {
+    munmap(window_, window_size_);
+  }
+
+  if (parsed_window_ != nullptr) {
+    munmap(parsed_window_, parsed_window_size_);
+  }
+}
+
+bool FileLoader::IsMapped() const { return is_mapped_; }
+
+bool FileLoader::IsFailed() const { return is_failed_; }
+
+std::span<const char> FileLoader::NextChunk() {
+  return is_mapped_ ? NextMappedChunk() : NextReadChunk();
+}
+
+bool FileLoader::NextRecord(const char delimiter,
+                            std::span<const char>& record) {
+  carry_.clear();
+
+  while (true) {
+    if (chunk_pos_ == chunk_.size()) {
+      chunk_ = NextChunk();
+      chunk_pos_ = 0;
+
+      if (chunk_.empty()) {
+        record = {carry_.data(), carry_.size()};
+
+        return !carry_.empty();
+      }
+    }
+
+    const char* begin = chunk_.data() + chunk_pos_;
+    uint64_t left = chunk_.size() - chunk_pos_;
+
+    const char* found =
+        static_cast<const char*>(std::memchr(begin, delimiter, left));
+
+    if (found == nullptr) {
+      carry_.append_range(std::span<const char>(begin, left));
+      chunk_pos_ = chunk_.size();
+
+      continue;
+    }
+
+    uint64_t size = static_cast<uint64_t>(found - begin);
+    chunk_pos_ += size + 1;
+
+    if (carry_.empty()) {
+      record = {begin, size};
+    } else {
+      carry_.append_range(std::span<const char>(begin, size));
+      record = {carry_.data(), carry_.size()};
+    }
+
+    return true;
+  }
+}
+
+bool FileLoader::MapWindow() {
+  window_size_ = std::min(chunk_size_, file_end_ - window_offset_);
+
+  void* mapping = mmap(nullptr, window_size_, PROT_READ, MAP_PRIVATE, fd_,
+                       static_cast<off_t>(window_offset_));
+
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  window_ = static_cast<char*>(mapping);
+  madvise(window_, window_size_, MADV_SEQUENTIAL);
+
+  // The kernel reads the next window ahead while this one is parsed.
+  uint64_t next_offset = window_offset_ + window_size_;
+
+  if (next_offset < file_end_) {
+    posix_fadvise(fd_, static_cast<off_t>(next_offset),
+                  static_cast<off_t>(
+                      std::min(chunk_size_, file_end_ - next_offset)),
+                  POSIX_FADV_WILLNEED);
+  }
+
+  return true;
+}
+
+void FileLoader::StartReader() {
+  buffers_[0] = new char[chunk_size_];
+  buffers_[1] = new char[chunk_size_];
+
+  reader_ = std::thread(&FileLoader::ReadBuffers, this);
+}
+
+// Mapping can still fail midway, e.g. when the address space runs out, so
+// the rest of the file is read from the first byte of the failed window.
+std::span<const char> FileLoader::NextMappedChunk() {
+  if (parsed_window_ != nullptr) {
+    munmap(parsed_window_, parsed_window_size_);
+    parsed_window_ = nullptr;
+  }
+
+  if (window_ == nullptr) {
+    if (window_offset_ >= file_end_) {
+      return {};
+    }
+
+    if (!MapWindow()) {
+      is_mapped_ = false;
+
+      off_t position = static_cast<off_t>(window_offset_ + window_skip_);
+
+      if (lseek(fd_, position, SEEK_SET) != position) {
+        is_failed_ = true;
+        is_read_finished_ = true;
+
+        return {};
+      }
+
+      StartReader();
+
+      return NextReadChunk();
+    }
+  }
+
+  std::span<const char> chunk(window_ + window_skip_,
+                              window_size_ - window_skip_);
+
+  parsed_window_ = std::exchange(window_, nullptr);
+  parsed_window_size_ = window_size_;
+
+  window_offset_ += window_size_;
+  window_skip_ = 0;
+
+  return chunk;
+}
+
+std::span<const char> FileLoader::NextReadChunk() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  if (is_holding_buffer_) {
+    is_buffer_ready_[parsed_buffer_] = false;
+    is_holding_buffer_ = false;
+    parsed_buffer_ ^= 1;
+
+    cv_.notify_all();
+  }
+
+  if (is_read_finished_) {
+    return {};
+  }
+
+  cv_.wait(lock, [this] { return is_buffer_ready_[parsed_buffer_]; });
+
+  is_holding_buffer_ = true;
+  is_read_finished_ = (buffer_sizes_[parsed_buffer_] < chunk_size_);
+
+  return {buffers_[parsed_buffer_], buffer_sizes_[parsed_buffer_]};
+}
+
+// A short read means the end of the file or a read error, as ReadFully
+// retries short reads of pipes and sockets.
+void FileLoader::ReadBuffers() {
+  for (uint64_t buffer_idx = 0;; buffer_idx ^= 1) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this, buffer_idx] {
+        return is_stopped_ || !is_buffer_ready_[buffer_idx];
+      });
+
+      if (is_stopped_) {
+        return;
+      }
+    }
+
+    uint64_t size = 0;
+    bool is_read = ReadFully(fd_, buffers_[buffer_idx], chunk_size_, size);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffer_sizes_[buffer_idx] = size;
+      is_buffer_ready_[buffer_idx] = true;
+      is_failed_ = !is_read;
+    }
+
+    cv_.notify_all();
+
+    if (size < chunk_size_) {
+      return;
+    }
+  }
+}
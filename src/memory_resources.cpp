@@ -0,0 +1,54 @@
+#include "../include/memory_resources.hpp"
+
+#include <algorithm>
+
+StackResource::StackResource() : pool_() {}
+
+StackPool<char>& StackResource::pool() {
+  return pool_;
+}
+
+void* StackResource::do_allocate(size_t bytes, size_t alignment) {
+  return pool_.Allocate(bytes, alignment);
+}
+
+void StackResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+  pool_.Deallocate(reinterpret_cast<char*>(ptr), bytes, alignment);
+}
+
+bool StackResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+SlabResource::SlabResource(std::pmr::memory_resource* upstream)
+    : engine_(), upstream_(upstream) {}
+
+SlabEngine& SlabResource::engine() {
+  return engine_;
+}
+
+void* SlabResource::do_allocate(size_t bytes, size_t alignment) {
+  if (alignment > MaxAlignment) {
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  // Objects of a power-of-two class are aligned to their class size up to the
+  // slab header size, so rounding small requests up covers the alignment.
+  return engine_.Allocate(std::max(bytes, alignment));
+}
+
+void SlabResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+  if (alignment > MaxAlignment) {
+    upstream_->deallocate(ptr, bytes, alignment);
+
+    return;
+  }
+
+  engine_.Deallocate(ptr, std::max(bytes, alignment));
+}
+
+bool SlabResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,160 @@
+#include "../include/os_memory.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <new>
+
+uint64_t GetOsPageSize() {
+  static const uint64_t page_size =
+      static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+
+  return page_size;
+}
+
+void ReleasePhysicalMemory(char* begin, char* end) {
+  const uint64_t page_size = GetOsPageSize();
+
+  uint64_t aligned_begin =
+      (reinterpret_cast<uint64_t>(begin) + page_size - 1) & ~(page_size - 1);
+  uint64_t aligned_end = reinterpret_cast<uint64_t>(end) & ~(page_size - 1);
+
+  if (aligned_begin >= aligned_end) {
+    return;
+  }
+
+  madvise(reinterpret_cast<void*>(aligned_begin), aligned_end - aligned_begin,
+          MADV_DONTNEED);
+}
+
+bool ReadFully(const int fd, char* data, const uint64_t bytes,
+               uint64_t& read_bytes) {
+  // Linux transfers at most about 2 GiB per call anyway.
+  constexpr uint64_t MaxReadSize = 0x40000000;
+
+  read_bytes = 0;
+
+  while (read_bytes < bytes) {
+    ssize_t result = read(fd, data + read_bytes,
+                          std::min(bytes - read_bytes, MaxReadSize));
+
+    if ((result < 0) && (errno == EINTR)) {
+      continue;
+    }
+
+    if (result < 0) {
+      return false;
+    }
+
+    if (result == 0) {
+      break;
+    }
+
+    read_bytes += static_cast<uint64_t>(result);
+  }
+
+  return true;
+}
+
+bool SeekBack(const int fd, const uint64_t bytes) {
+  return lseek(fd, -static_cast<off_t>(bytes), SEEK_CUR) >= 0;
+}
+
+HugePageArena::HugePageArena(const uint64_t chunk_size)
+    : chunk_size_(chunk_size),
+      region_size_(((chunk_size + HugePageSize - 1) / HugePageSize) *
+                   HugePageSize),
+      regions_(nullptr),
+      region_ptr_(nullptr),
+      region_end_(nullptr),
+      free_chunks_(nullptr) {}
+
+HugePageArena::~HugePageArena() {
+  while (free_chunks_ != nullptr) {
+    FreeChunk* free_chunk = free_chunks_;
+    free_chunks_ = free_chunk->next_;
+
+    delete free_chunk;
+  }
+
+  while (regions_ != nullptr) {
+    Region* region = regions_;
+    regions_ = region->next_;
+
+    munmap(region->begin_, region->size_);
+    delete region;
+  }
+
+  region_ptr_ = nullptr;
+  region_end_ = nullptr;
+}
+
+char* HugePageArena::AllocateChunk() {
+  if (free_chunks_ != nullptr) {
+    FreeChunk* free_chunk = free_chunks_;
+    char* chunk = free_chunk->chunk_;
+
+    free_chunks_ = free_chunk->next_;
+    delete free_chunk;
+
+    return chunk;
+  }
+
+  if ((region_ptr_ == nullptr) || ((region_ptr_ + chunk_size_) > region_end_)) {
+    char* region_begin = MapRegion(region_size_);
+
+    regions_ = new Region{region_begin, region_size_, regions_};
+    region_ptr_ = region_begin;
+    region_end_ = region_begin + region_size_;
+  }
+
+  char* chunk = region_ptr_;
+  region_ptr_ += chunk_size_;
+
+  return chunk;
+}
+
+void HugePageArena::DeallocateChunk(char* chunk) {
+  ReleasePhysicalMemory(chunk, chunk + chunk_size_);
+
+  free_chunks_ = new FreeChunk{chunk, free_chunks_};
+}
+
+uint64_t HugePageArena::GetMappedBytes() const {
+  uint64_t mapped_bytes = 0;
+
+  for (Region* region = regions_; region != nullptr; region = region->next_) {
+    mapped_bytes += region->size_;
+  }
+
+  return mapped_bytes;
+}
+
+char* HugePageArena::MapRegion(const uint64_t size) {
+  void* mapping = mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (mapping == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+
+  uint64_t mapping_begin = reinterpret_cast<uint64_t>(mapping);
+  uint64_t aligned_begin =
+      (mapping_begin + HugePageSize - 1) & ~(HugePageSize - 1);
+  uint64_t mapping_end = mapping_begin + size + HugePageSize;
+
+  if (aligned_begin != mapping_begin) {
+    munmap(mapping, aligned_begin - mapping_begin);
+  }
+
+  if ((aligned_begin + size) != mapping_end) {
+    munmap(reinterpret_cast<void*>(aligned_begin + size),
+           mapping_end - (aligned_begin + size));
+  }
+
+  madvise(reinterpret_cast<void*>(aligned_begin), size, MADV_HUGEPAGE);
+
+  return reinterpret_cast<char*>(aligned_begin);
+}
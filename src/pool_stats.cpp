@@ -0,0 +1,16 @@
+#include "../include/pool_stats.hpp"
+
+void PoolStats::Dump(std::ostream& stream, const char* prefix) const {
+  stream << prefix << ".allocations " << allocations_ << '\n'
+         << prefix << ".frees " << frees_ << '\n'
+         << prefix << ".reallocations " << reallocations_ << '\n'
+         << prefix << ".bytes_in_use " << bytes_in_use_ << '\n'
+         << prefix << ".high_watermark_bytes " << high_watermark_bytes_ << '\n'
+         << prefix << ".entries " << entries_amount_ << '\n'
+         << prefix << ".reserved_bytes " << reserved_bytes_ << '\n'
+         << prefix << ".fragmented_bytes " << fragmented_bytes_ << '\n'
+         << prefix << ".entry_scans " << entry_scans_ << '\n'
+         << prefix << ".max_entry_scan " << max_entry_scan_ << '\n'
+         << prefix << ".ptr_scans " << ptr_scans_ << '\n'
+         << prefix << ".max_ptr_scan " << max_ptr_scan_ << '\n';
+}
@@ -0,0 +1,455 @@
+#include "../include/simd.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+// Find and Count look for exact values, floating point ones included.
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+
+template <typename T>
+static uint64_t ScalarFind(const T* data, const uint64_t size, const T value) {
+  return static_cast<uint64_t>(std::find(data, data + size, value) - data);
+}
+
+template <typename T>
+static uint64_t ScalarCount(const T* data, const uint64_t size,
+                            const T value) {
+  return static_cast<uint64_t>(std::count(data, data + size, value));
+}
+
+template <typename T, bool IsMax>
+static uint64_t ScalarExtremeElement(const T* data, const uint64_t size) {
+  if constexpr (IsMax) {
+    return static_cast<uint64_t>(std::max_element(data, data + size) - data);
+  } else {
+    return static_cast<uint64_t>(std::min_element(data, data + size) - data);
+  }
+}
+
+template <typename T>
+static T ScalarSum(const T* data, const uint64_t size) {
+  return std::accumulate(data, data + size, T());
+}
+
+#if defined(__x86_64__)
+
+// The kernels are written once with GCC vector extensions and instantiated
+// per vector width inside target-specific wrappers, so each width compiles
+// to that instruction set. They must be inlined into the wrappers.
+template <typename T, uint64_t Bytes>
+struct SimdTraits {
+  typedef T Vec __attribute__((vector_size(Bytes)));
+  typedef T UnalignedVec
+      __attribute__((vector_size(Bytes), aligned(1), may_alias));
+
+  static constexpr uint64_t Lanes = Bytes / sizeof(T);
+};
+
+template <typename T, uint64_t Bytes>
+__attribute__((always_inline)) inline uint64_t FindKernel(const T* data,
+                                                          const uint64_t size,
+                                                          const T value) {
+  using Traits = SimdTraits<T, Bytes>;
+
+  const auto* blocks =
+      reinterpret_cast<const typename Traits::UnalignedVec*>(data);
+  const typename Traits::Vec needle = typename Traits::Vec{} + value;
+  uint64_t idx = 0;
+
+  for (; idx + Traits::Lanes <= size; idx += Traits::Lanes) {
+    auto mask = blocks[idx / Traits::Lanes] == needle;
+    bool is_found = false;
+
+    for (uint64_t lane = 0; lane < Traits::Lanes; lane++) {
+      is_found |= (mask[lane] != 0);
+    }
+
+    if (is_found) {
+      break;
+    }
+  }
+
+  for (; idx < size; idx++) {
+    if (data[idx] == value) {
+      return idx;
+    }
+  }
+
+  return size;
+}
+
+template <typename T, uint64_t Bytes>
+__attribute__((always_inline)) inline uint64_t CountKernel(const T* data,
+                                                           const uint64_t size,
+                                                           const T value) {
+  using Traits = SimdTraits<T, Bytes>;
+
+  const auto* blocks =
+      reinterpret_cast<const typename Traits::UnalignedVec*>(data);
+  const typename Traits::Vec needle = typename Traits::Vec{} + value;
+  using Counters = decltype(needle == needle);
+  using Counter = std::remove_cvref_t<decltype(Counters{}[0])>;
+
+  // Lane counters are as narrow as T, so they are flushed into the total
+  // before they can overflow.
+  constexpr uint64_t FlushIterations = std::numeric_limits<Counter>::max();
+
+  uint64_t count = 0;
+  uint64_t idx = 0;
+
+  while (idx + Traits::Lanes <= size) {
+    uint64_t iterations =
+        std::min((size - idx) / Traits::Lanes, FlushIterations);
+    Counters counters = {};
+
+    // Matching lanes compare to -1, so subtracting the mask counts them.
+    for (; iterations > 0; iterations--, idx += Traits::Lanes) {
+      counters -= (blocks[idx / Traits::Lanes] == needle);
+    }
+
+    for (uint64_t lane = 0; lane < Traits::Lanes; lane++) {
+      count += static_cast<uint64_t>(counters[lane]);
+    }
+  }
+
+  for (; idx < size; idx++) {
+    count += (data[idx] == value) ? 1 : 0;
+  }
+
+  return count;
+}
+
+template <typename T, uint64_t Bytes, bool IsMax>
+__attribute__((always_inline)) inline T ExtremeKernel(const T* data,
+                                                      const uint64_t size) {
+  using Traits = SimdTraits<T, Bytes>;
+
+  const auto* blocks =
+      reinterpret_cast<const typename Traits::UnalignedVec*>(data);
+  typename Traits::Vec best = typename Traits::Vec{} + data[0];
+  uint64_t idx = 0;
+
+  for (; idx + Traits::Lanes <= size; idx += Traits::Lanes) {
+    typename Traits::Vec block = blocks[idx / Traits::Lanes];
+
+    if constexpr (IsMax) {
+      best = (block > best) ? block : best;
+    } else {
+      best = (block < best) ? block : best;
+    }
+  }
+
+  T result = best[0];
+
+  for (uint64_t lane = 1; lane < Traits::Lanes; lane++) {
+    if (IsMax ? (best[lane] > result) : (best[lane] < result)) {
+      result = best[lane];
+    }
+  }
+
+  for (; idx < size; idx++) {
+    if (IsMax ? (data[idx] > result) : (data[idx] < result)) {
+      result = data[idx];
+    }
+  }
+
+  return result;
+}
+
+template <typename T, uint64_t Bytes>
+__attribute__((always_inline)) inline T SumKernel(const T* data,
+                                                  const uint64_t size) {
+  using Traits = SimdTraits<T, Bytes>;
+
+  const auto* blocks =
+      reinterpret_cast<const typename Traits::UnalignedVec*>(data);
+
+  // Independent accumulators hide the add latency.
+  typename Traits::Vec sums[4] = {};
+  uint64_t idx = 0;
+
+  for (; idx + 4 * Traits::Lanes <= size; idx += 4 * Traits::Lanes) {
+    sums[0] += blocks[idx / Traits::Lanes];
+    sums[1] += blocks[idx / Traits::Lanes + 1];
+    sums[2] += blocks[idx / Traits::Lanes + 2];
+    sums[3] += blocks[idx / Traits::Lanes + 3];
+  }
+
+  for (; idx + Traits::Lanes <= size; idx += Traits::Lanes) {
+    sums[0] += blocks[idx / Traits::Lanes];
+  }
+
+  typename Traits::Vec total = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+  T sum = T();
+
+  for (uint64_t lane = 0; lane < Traits::Lanes; lane++) {
+    sum += total[lane];
+  }
+
+  for (; idx < size; idx++) {
+    sum += data[idx];
+  }
+
+  return sum;
+}
+
+#define SIMD_SSE_TARGET __attribute__((target("sse4.2")))
+#define SIMD_AVX2_TARGET __attribute__((target("avx2")))
+#define SIMD_AVX512_TARGET \
+  __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+
+template <typename T>
+SIMD_SSE_TARGET uint64_t FindSse(const T* data, const uint64_t size,
+                                 const T value) {
+  return FindKernel<T, 16>(data, size, value);
+}
+
+template <typename T>
+SIMD_AVX2_TARGET uint64_t FindAvx2(const T* data, const uint64_t size,
+                                   const T value) {
+  return FindKernel<T, 32>(data, size, value);
+}
+
+template <typename T>
+SIMD_AVX512_TARGET uint64_t FindAvx512(const T* data, const uint64_t size,
+                                       const T value) {
+  return FindKernel<T, 64>(data, size, value);
+}
+
+template <typename T>
+SIMD_SSE_TARGET uint64_t CountSse(const T* data, const uint64_t size,
+                                  const T value) {
+  return CountKernel<T, 16>(data, size, value);
+}
+
+template <typename T>
+SIMD_AVX2_TARGET uint64_t CountAvx2(const T* data, const uint64_t size,
+                                    const T value) {
+  return CountKernel<T, 32>(data, size, value);
+}
+
+template <typename T>
+SIMD_AVX512_TARGET uint64_t CountAvx512(const T* data, const uint64_t size,
+                                        const T value) {
+  return CountKernel<T, 64>(data, size, value);
+}
+
+template <typename T, bool IsMax>
+SIMD_SSE_TARGET T ExtremeSse(const T* data, const uint64_t size) {
+  return ExtremeKernel<T, 16, IsMax>(data, size);
+}
+
+template <typename T, bool IsMax>
+SIMD_AVX2_TARGET T ExtremeAvx2(const T* data, const uint64_t size) {
+  return ExtremeKernel<T, 32, IsMax>(data, size);
+}
+
+template <typename T, bool IsMax>
+SIMD_AVX512_TARGET T ExtremeAvx512(const T* data, const uint64_t size) {
+  return ExtremeKernel<T, 64, IsMax>(data, size);
+}
+
+template <typename T>
+SIMD_SSE_TARGET T SumSse(const T* data, const uint64_t size) {
+  return SumKernel<T, 16>(data, size);
+}
+
+template <typename T>
+SIMD_AVX2_TARGET T SumAvx2(const T* data, const uint64_t size) {
+  return SumKernel<T, 32>(data, size);
+}
+
+template <typename T>
+SIMD_AVX512_TARGET T SumAvx512(const T* data, const uint64_t size) {
+  return SumKernel<T, 64>(data, size);
+}
+
+#undef SIMD_SSE_TARGET
+#undef SIMD_AVX2_TARGET
+#undef SIMD_AVX512_TARGET
+
+static SimdLevel DetectSimdLevel() {
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+    return SimdLevel::Avx512;
+  }
+
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::Avx2;
+  }
+
+  if (__builtin_cpu_supports("sse4.2")) {
+    return SimdLevel::Sse;
+  }
+
+  return SimdLevel::Scalar;
+}
+
+template <typename T>
+uint64_t SimdFind(const T* data, const uint64_t size, const T value) {
+  switch (GetSimdLevel()) {
+    case SimdLevel::Avx512:
+      return FindAvx512(data, size, value);
+    case SimdLevel::Avx2:
+      return FindAvx2(data, size, value);
+    case SimdLevel::Sse:
+      return FindSse(data, size, value);
+    case SimdLevel::Scalar:
+    default:
+      return ScalarFind(data, size, value);
+  }
+}
+
+template <typename T>
+uint64_t SimdCount(const T* data, const uint64_t size, const T value) {
+  switch (GetSimdLevel()) {
+    case SimdLevel::Avx512:
+      return CountAvx512(data, size, value);
+    case SimdLevel::Avx2:
+      return CountAvx2(data, size, value);
+    case SimdLevel::Sse:
+      return CountSse(data, size, value);
+    case SimdLevel::Scalar:
+    default:
+      return ScalarCount(data, size, value);
+  }
+}
+
+// Finds the extreme value with vector compares and then its first position,
+// which matches std::min_element and std::max_element. Values that compare
+// unordered (NaN) can make the second pass miss, so those arrays fall back
+// to the scalar search.
+template <typename T, bool IsMax>
+static uint64_t SimdExtremeElement(const T* data, const uint64_t size) {
+  if (size == 0) {
+    return 0;
+  }
+
+  T extreme = T();
+
+  switch (GetSimdLevel()) {
+    case SimdLevel::Avx512:
+      extreme = ExtremeAvx512<T, IsMax>(data, size);
+      break;
+    case SimdLevel::Avx2:
+      extreme = ExtremeAvx2<T, IsMax>(data, size);
+      break;
+    case SimdLevel::Sse:
+      extreme = ExtremeSse<T, IsMax>(data, size);
+      break;
+    case SimdLevel::Scalar:
+    default:
+      return ScalarExtremeElement<T, IsMax>(data, size);
+  }
+
+  uint64_t idx = SimdFind(data, size, extreme);
+
+  if (idx == size) {
+    return ScalarExtremeElement<T, IsMax>(data, size);
+  }
+
+  return idx;
+}
+
+template <typename T>
+uint64_t SimdMinElement(const T* data, const uint64_t size) {
+  return SimdExtremeElement<T, false>(data, size);
+}
+
+template <typename T>
+uint64_t SimdMaxElement(const T* data, const uint64_t size) {
+  return SimdExtremeElement<T, true>(data, size);
+}
+
+template <typename T>
+T SimdSum(const T* data, const uint64_t size) {
+  switch (GetSimdLevel()) {
+    case SimdLevel::Avx512:
+      return SumAvx512(data, size);
+    case SimdLevel::Avx2:
+      return SumAvx2(data, size);
+    case SimdLevel::Sse:
+      return SumSse(data, size);
+    case SimdLevel::Scalar:
+    default:
+      return ScalarSum(data, size);
+  }
+}
+
+#else
+
+static SimdLevel DetectSimdLevel() {
+  return SimdLevel::Scalar;
+}
+
+template <typename T>
+uint64_t SimdFind(const T* data, const uint64_t size, const T value) {
+  return ScalarFind(data, size, value);
+}
+
+template <typename T>
+uint64_t SimdCount(const T* data, const uint64_t size, const T value) {
+  return ScalarCount(data, size, value);
+}
+
+template <typename T>
+uint64_t SimdMinElement(const T* data, const uint64_t size) {
+  return ScalarExtremeElement<T, false>(data, size);
+}
+
+template <typename T>
+uint64_t SimdMaxElement(const T* data, const uint64_t size) {
+  return ScalarExtremeElement<T, true>(data, size);
+}
+
+template <typename T>
+T SimdSum(const T* data, const uint64_t size) {
+  return ScalarSum(data, size);
+}
+
+#endif
+
+SimdLevel GetSimdLevel() {
+  static const SimdLevel level = DetectSimdLevel();
+
+  return level;
+}
+
+template uint64_t SimdFind(const int32_t*, const uint64_t, const int32_t);
+template uint64_t SimdFind(const uint32_t*, const uint64_t, const uint32_t);
+template uint64_t SimdFind(const int64_t*, const uint64_t, const int64_t);
+template uint64_t SimdFind(const uint64_t*, const uint64_t, const uint64_t);
+template uint64_t SimdFind(const float*, const uint64_t, const float);
+template uint64_t SimdFind(const double*, const uint64_t, const double);
+
+template uint64_t SimdCount(const int32_t*, const uint64_t, const int32_t);
+template uint64_t SimdCount(const uint32_t*, const uint64_t, const uint32_t);
+template uint64_t SimdCount(const int64_t*, const uint64_t, const int64_t);
+template uint64_t SimdCount(const uint64_t*, const uint64_t, const uint64_t);
+template uint64_t SimdCount(const float*, const uint64_t, const float);
+template uint64_t SimdCount(const double*, const uint64_t, const double);
+
+template uint64_t SimdMinElement(const int32_t*, const uint64_t);
+template uint64_t SimdMinElement(const uint32_t*, const uint64_t);
+template uint64_t SimdMinElement(const int64_t*, const uint64_t);
+template uint64_t SimdMinElement(const uint64_t*, const uint64_t);
+template uint64_t SimdMinElement(const float*, const uint64_t);
+template uint64_t SimdMinElement(const double*, const uint64_t);
+
+template uint64_t SimdMaxElement(const int32_t*, const uint64_t);
+template uint64_t SimdMaxElement(const uint32_t*, const uint64_t);
+template uint64_t SimdMaxElement(const int64_t*, const uint64_t);
+template uint64_t SimdMaxElement(const uint64_t*, const uint64_t);
+template uint64_t SimdMaxElement(const float*, const uint64_t);
+template uint64_t SimdMaxElement(const double*, const uint64_t);
+
+template int32_t SimdSum(const int32_t*, const uint64_t);
+template uint32_t SimdSum(const uint32_t*, const uint64_t);
+template int64_t SimdSum(const int64_t*, const uint64_t);
+template uint64_t SimdSum(const uint64_t*, const uint64_t);
+template float SimdSum(const float*, const uint64_t);
+template double SimdSum(const double*, const uint64_t);
@@ -0,0 +1,289 @@
+#include "../include/slab_pool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "../include/os_memory.hpp"
+
+char* SlabEngine::Slab::GetData() const {
+  return reinterpret_cast<char*>(const_cast<Slab*>(this)) + SlabHeaderSize;
+}
+
+SlabEngine::SlabEngine()
+    : available_(),
+      full_(),
+      large_(nullptr),
+      reserved_bytes_(0),
+      owner_thread_() {}
+
+SlabEngine::SlabEngine(const std::thread::id owner_thread) : SlabEngine() {
+  owner_thread_ = owner_thread;
+}
+
+SlabEngine::~SlabEngine() {
+  for (uint64_t class_idx = 0; class_idx < ClassesAmount; class_idx++) {
+    while (available_[class_idx] != nullptr) {
+      Slab* slab = available_[class_idx];
+
+      Unlink(available_[class_idx], slab);
+      DestroySlab(slab);
+    }
+
+    while (full_[class_idx] != nullptr) {
+      Slab* slab = full_[class_idx];
+
+      Unlink(full_[class_idx], slab);
+      DestroySlab(slab);
+    }
+  }
+
+  while (large_ != nullptr) {
+    Slab* slab = large_;
+
+    Unlink(large_, slab);
+    DestroySlab(slab);
+  }
+}
+
+void* SlabEngine::Allocate(const uint64_t bytes) {
+  assert(IsOwnerThread() && "Default slab engine used from another thread");
+
+  if (bytes > MaxClassSize) {
+    return AllocateLarge(bytes);
+  }
+
+  uint64_t class_idx = GetClassIdx(bytes);
+
+  if (available_[class_idx] == nullptr) {
+    Link(available_[class_idx], CreateSlab(class_idx, SlabSize));
+  }
+
+  Slab* slab = available_[class_idx];
+  void* ptr = nullptr;
+
+  if (slab->free_list_ != nullptr) {
+    ptr = slab->free_list_;
+    slab->free_list_ = *reinterpret_cast<void**>(ptr);
+  } else {
+    assert((slab->bump_ + slab->class_size_) <= slab->end_);
+
+    ptr = slab->bump_;
+    slab->bump_ += slab->class_size_;
+  }
+
+  if (--slab->free_amount_ == 0) {
+    Unlink(available_[class_idx], slab);
+    Link(full_[class_idx], slab);
+  }
+
+  return ptr;
+}
+
+void SlabEngine::Deallocate(void* ptr,
+                            [[maybe_unused]] const uint64_t bytes) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  assert(IsOwnerThread() && "Default slab engine used from another thread");
+
+  Slab* slab = GetSlabByPtr(ptr);
+
+  if (slab->class_idx_ == LargeClassIdx) {
+    assert(bytes <= slab->class_size_);
+
+    Unlink(large_, slab);
+    DestroySlab(slab);
+
+    return;
+  }
+
+  assert((bytes == 0) || (GetClassIdx(bytes) == slab->class_idx_));
+
+  *reinterpret_cast<void**>(ptr) = slab->free_list_;
+  slab->free_list_ = ptr;
+
+  if (slab->free_amount_++ == 0) {
+    Unlink(full_[slab->class_idx_], slab);
+    Link(available_[slab->class_idx_], slab);
+  }
+}
+
+void* SlabEngine::Reallocate(void* ptr, const uint64_t new_bytes) {
+  if (ptr == nullptr) {
+    return Allocate(new_bytes);
+  }
+
+  Slab* slab = GetSlabByPtr(ptr);
+  uint64_t old_bytes = slab->class_size_;
+
+  if ((new_bytes <= old_bytes) &&
+      ((slab->class_idx_ == LargeClassIdx) ||
+       (GetClassIdx(new_bytes) == slab->class_idx_))) {
+    return ptr;
+  }
+
+  void* new_ptr = Allocate(new_bytes);
+  std::memcpy(new_ptr, ptr, std::min(old_bytes, new_bytes));
+
+  Deallocate(ptr, old_bytes);
+
+  return new_ptr;
+}
+
+uint64_t SlabEngine::GetReservedBytes() const {
+  return reserved_bytes_;
+}
+
+void SlabEngine::Trim(const uint64_t target_bytes) {
+  assert(IsOwnerThread() && "Default slab engine used from another thread");
+
+  for (uint64_t class_idx = 0; class_idx < ClassesAmount; class_idx++) {
+    uint64_t warm_slabs = 0;
+    Slab* slab = available_[class_idx];
+
+    while (slab != nullptr) {
+      Slab* next_slab = slab->next_;
+
+      if (slab->free_amount_ == slab->capacity_) {
+        if ((warm_slabs >= WarmSlabsAmount) &&
+            (reserved_bytes_ > target_bytes)) {
+          Unlink(available_[class_idx], slab);
+          DestroySlab(slab);
+        } else {
+          warm_slabs++;
+        }
+      }
+
+      slab = next_slab;
+    }
+  }
+
+  if (reserved_bytes_ <= target_bytes) {
+    return;
+  }
+
+  for (uint64_t class_idx = 0; class_idx < ClassesAmount; class_idx++) {
+    for (Slab* slab = available_[class_idx]; slab != nullptr;
+         slab = slab->next_) {
+      if (slab->free_amount_ != slab->capacity_) {
+        continue;
+      }
+
+      slab->free_list_ = nullptr;
+      slab->bump_ = slab->GetData();
+
+      ReleasePhysicalMemory(slab->GetData(), slab->end_);
+    }
+  }
+}
+
+SlabEngine& SlabEngine::GetDefault() {
+  thread_local SlabEngine engine(std::this_thread::get_id());
+
+  return engine;
+}
+
+bool SlabEngine::IsOwnerThread() const {
+  return (owner_thread_ == std::thread::id()) ||
+         (owner_thread_ == std::this_thread::get_id());
+}
+
+uint64_t SlabEngine::GetClassIdx(const uint64_t bytes) {
+  if (bytes <= (1ull << MinClassShift)) {
+    return 0;
+  }
+
+  uint64_t class_shift =
+      64 - static_cast<uint64_t>(__builtin_clzll(bytes - 1));
+
+  return class_shift - MinClassShift;
+}
+
+SlabEngine::Slab* SlabEngine::GetSlabByPtr(void* ptr) {
+  Slab* slab = reinterpret_cast<Slab*>(reinterpret_cast<uint64_t>(ptr) &
+                                       ~(SlabSize - 1));
+
+  assert((reinterpret_cast<char*>(ptr) >= slab->GetData()) &&
+         (reinterpret_cast<char*>(ptr) < slab->end_));
+
+  return slab;
+}
+
+void SlabEngine::Link(Slab*& list, Slab* slab) {
+  slab->prev_ = nullptr;
+  slab->next_ = list;
+
+  if (list != nullptr) {
+    list->prev_ = slab;
+  }
+
+  list = slab;
+}
+
+void SlabEngine::Unlink(Slab*& list, Slab* slab) {
+  if (slab->prev_ != nullptr) {
+    slab->prev_->next_ = slab->next_;
+  } else {
+    list = slab->next_;
+  }
+
+  if (slab->next_ != nullptr) {
+    slab->next_->prev_ = slab->prev_;
+  }
+
+  slab->prev_ = nullptr;
+  slab->next_ = nullptr;
+}
+
+SlabEngine::Slab* SlabEngine::CreateSlab(const uint64_t class_idx,
+                                         const uint64_t chunk_size) {
+  void* memory = std::aligned_alloc(SlabSize, chunk_size);
+
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  uint64_t class_size = (class_idx == LargeClassIdx)
+                            ? (chunk_size - SlabHeaderSize)
+                            : (1ull << (class_idx + MinClassShift));
+  uint64_t capacity = (chunk_size - SlabHeaderSize) / class_size;
+
+  Slab* slab = new (memory) Slab{class_idx,
+                                 class_size,
+                                 chunk_size,
+                                 nullptr,
+                                 nullptr,
+                                 nullptr,
+                                 capacity,
+                                 capacity,
+                                 nullptr,
+                                 nullptr};
+
+  slab->bump_ = slab->GetData();
+  slab->end_ = slab->GetData() + capacity * class_size;
+
+  reserved_bytes_ += chunk_size;
+
+  return slab;
+}
+
+void SlabEngine::DestroySlab(Slab* slab) {
+  reserved_bytes_ -= slab->chunk_size_;
+
+  slab->~Slab();
+  std::free(slab);
+}
+
+void* SlabEngine::AllocateLarge(const uint64_t bytes) {
+  uint64_t chunk_size =
+      ((SlabHeaderSize + bytes + SlabSize - 1) / SlabSize) * SlabSize;
+
+  Slab* slab = CreateSlab(LargeClassIdx, chunk_size);
+  slab->free_amount_ = 0;
+
+  Link(large_, slab);
+
+  return slab->GetData();
+}
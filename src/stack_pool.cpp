@@ -1,2 +1,8 @@
 #include "../include/stack_pool.hpp"
 
+
+StackArena& GetDefaultStackArena() {
+  thread_local StackArena arena(std::this_thread::get_id());
+
+  return arena;
+}
@@ -0,0 +1,220 @@
+#include "../include/thread_pool.hpp"
+
+#include <algorithm>
+
+static thread_local const ThreadPool* current_pool = nullptr;
+static thread_local uint64_t current_worker_idx = 0;
+
+static std::atomic<uint64_t> parallel_threshold{DefaultParallelThreshold};
+
+ThreadPool::ThreadPool(const uint64_t workers_amount)
+    : workers_amount_(workers_amount),
+      workers_(nullptr),
+      queues_(new WorkQueue[workers_amount + 1]),
+      queued_jobs_(0),
+      sleeping_workers_(0),
+      sleep_mutex_(),
+      sleep_cv_(),
+      stop_(false) {
+  if (workers_amount_ == 0) {
+    return;
+  }
+
+  workers_ = new std::thread[workers_amount_];
+
+  for (uint64_t worker_idx = 0; worker_idx < workers_amount_; worker_idx++) {
+    workers_[worker_idx] =
+        std::thread(&ThreadPool::WorkerLoop, this, worker_idx);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+
+  sleep_cv_.notify_all();
+
+  for (uint64_t worker_idx = 0; worker_idx < workers_amount_; worker_idx++) {
+    workers_[worker_idx].join();
+  }
+
+  delete[] workers_;
+  workers_ = nullptr;
+  workers_amount_ = 0;
+
+  delete[] queues_;
+  queues_ = nullptr;
+}
+
+void ThreadPool::Run(Task task, void* context, const uint64_t tasks_amount) {
+  if ((workers_amount_ == 0) || (tasks_amount < 2)) {
+    for (uint64_t task_idx = 0; task_idx < tasks_amount; task_idx++) {
+      task(context, task_idx);
+    }
+
+    return;
+  }
+
+  std::atomic<uint64_t> pending(tasks_amount - 1);
+
+  for (uint64_t task_idx = tasks_amount - 1; task_idx > 0; task_idx--) {
+    Submit({task, context, task_idx, &pending});
+  }
+
+  task(context, 0);
+
+  Wait(pending);
+}
+
+void ThreadPool::Submit(const Job& job) {
+  if (workers_amount_ == 0) {
+    RunJob(job);
+
+    return;
+  }
+
+  uint64_t worker_idx = GetWorkerIdx();
+  WorkQueue& queue =
+      queues_[(worker_idx == NoWorkerIdx) ? workers_amount_ : worker_idx];
+
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex_);
+    queue.jobs_.push_back(job);
+  }
+
+  queued_jobs_.fetch_add(1);
+
+  if (sleeping_workers_.load() != 0) {
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+
+    sleep_cv_.notify_one();
+  }
+}
+
+void ThreadPool::Wait(const std::atomic<uint64_t>& pending) {
+  while (pending.load(std::memory_order_acquire) != 0) {
+    if (!TryRunJob()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+uint64_t ThreadPool::GetThreadsAmount() const {
+  return workers_amount_ + 1;
+}
+
+// Never destroyed, so containers with static storage can still use it while
+// they are destroyed at exit.
+ThreadPool& ThreadPool::GetDefault() {
+  static ThreadPool* pool = new ThreadPool(
+      std::max<uint64_t>(std::thread::hardware_concurrency(), 1) - 1);
+
+  return *pool;
+}
+
+void ThreadPool::WorkerLoop(const uint64_t worker_idx) {
+  current_pool = this;
+  current_worker_idx = worker_idx;
+
+  while (true) {
+    if (TryRunJob()) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+
+    sleeping_workers_.fetch_add(1);
+    sleep_cv_.wait(lock,
+                   [this] { return stop_ || (queued_jobs_.load() != 0); });
+    sleeping_workers_.fetch_sub(1);
+
+    if (stop_) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::TryRunJob() {
+  Job job = {};
+
+  if (!TryPopJob(job)) {
+    return false;
+  }
+
+  queued_jobs_.fetch_sub(1);
+  RunJob(job);
+
+  return true;
+}
+
+bool ThreadPool::TryPopJob(Job& job) {
+  uint64_t worker_idx = GetWorkerIdx();
+  uint64_t queues_amount = workers_amount_ + 1;
+
+  if ((worker_idx != NoWorkerIdx) &&
+      TryTakeJob(queues_[worker_idx], job, true)) {
+    return true;
+  }
+
+  uint64_t start_idx = (worker_idx == NoWorkerIdx) ? workers_amount_
+                                                   : worker_idx + 1;
+
+  for (uint64_t shift = 0; shift < queues_amount; shift++) {
+    uint64_t queue_idx = (start_idx + shift) % queues_amount;
+
+    if ((queue_idx != worker_idx) &&
+        TryTakeJob(queues_[queue_idx], job, false)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ThreadPool::TryTakeJob(WorkQueue& queue, Job& job, const bool from_back) {
+  std::lock_guard<std::mutex> lock(queue.mutex_);
+
+  if (queue.jobs_.empty()) {
+    return false;
+  }
+
+  if (from_back) {
+    job = queue.jobs_.back();
+    queue.jobs_.pop_back();
+  } else {
+    job = queue.jobs_.front();
+    queue.jobs_.pop_front();
+  }
+
+  return true;
+}
+
+void ThreadPool::RunJob(const Job& job) {
+  job.task_(job.context_, job.task_idx_);
+
+  job.pending_->fetch_sub(1, std::memory_order_release);
+}
+
+uint64_t ThreadPool::GetWorkerIdx() const {
+  return (current_pool == this) ? current_worker_idx : NoWorkerIdx;
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool_(pool), pending_(0) {}
+
+TaskGroup::~TaskGroup() {
+  Wait();
+}
+
+void TaskGroup::Wait() {
+  pool_.Wait(pending_);
+}
+
+uint64_t GetParallelThreshold() {
+  return parallel_threshold.load(std::memory_order_relaxed);
+}
+
+void SetParallelThreshold(const uint64_t threshold_bytes) {
+  parallel_threshold.store(threshold_bytes, std::memory_order_relaxed);
+}
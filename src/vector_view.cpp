@@ -0,0 +1,118 @@
+#include "../include/vector_view.hpp"
+
+#include <bit>
+
+#include "../include/simd.hpp"
+
+// Bits [from, to) of one word, to is at most 64.
+static uint64_t GetRangeMask(const uint64_t from, const uint64_t to) {
+  uint64_t high_mask = (to == 64) ? UINT64_MAX : ((1ull << to) - 1);
+
+  return high_mask & ~((1ull << from) - 1);
+}
+
+BitView::BitView() : data_(nullptr), offset_(0), size_(0) {}
+
+BitView::BitView(const uint64_t* data, const uint64_t offset,
+                 const uint64_t size)
+    : data_(data + offset / WordBits),
+      offset_(offset % WordBits),
+      size_(size) {}
+
+bool BitView::empty() const { return (size_ == 0); }
+
+uint64_t BitView::size() const { return size_; }
+
+const uint64_t* BitView::data() const { return data_; }
+
+uint64_t BitView::offset() const { return offset_; }
+
+bool BitView::at(const uint64_t idx) const {
+  assert(idx < size_);
+
+  return (*this)[idx];
+}
+
+bool BitView::operator[](const uint64_t idx) const {
+  uint64_t bit = offset_ + idx;
+
+  return (data_[bit / WordBits] >> (bit % WordBits)) & 1;
+}
+
+BitView BitView::subview(const uint64_t offset, const uint64_t length) const {
+  assert(offset + length <= size_);
+
+  return {data_, offset_ + offset, length};
+}
+
+uint64_t Count(const BitView view, const bool value) {
+  if (view.empty()) {
+    return 0;
+  }
+
+  const uint64_t* data = view.data();
+  uint64_t from = view.offset();
+  uint64_t to = from + view.size();
+  uint64_t last_word = (to - 1) / 64;
+
+  uint64_t ones = 0;
+
+  if (last_word == 0) {
+    ones = static_cast<uint64_t>(
+        std::popcount(data[0] & GetRangeMask(from, to)));
+  } else {
+    ones = static_cast<uint64_t>(
+        std::popcount(data[0] & GetRangeMask(from, 64)));
+
+    for (uint64_t word_idx = 1; word_idx < last_word; word_idx++) {
+      ones += static_cast<uint64_t>(std::popcount(data[word_idx]));
+    }
+
+    ones += static_cast<uint64_t>(std::popcount(
+        data[last_word] & GetRangeMask(0, to - last_word * 64)));
+  }
+
+  return value ? ones : view.size() - ones;
+}
+
+uint64_t Find(const BitView view, const bool value) {
+  if (view.empty()) {
+    return 0;
+  }
+
+  const uint64_t* data = view.data();
+  uint64_t from = view.offset();
+  uint64_t to = from + view.size();
+  uint64_t last_word = (to - 1) / 64;
+
+  for (uint64_t word_idx = 0; word_idx <= last_word; word_idx++) {
+    uint64_t word_from = (word_idx == 0) ? from : 0;
+    uint64_t word_to = (word_idx == last_word) ? to - last_word * 64 : 64;
+
+    uint64_t word = value ? data[word_idx] : ~data[word_idx];
+    word &= GetRangeMask(word_from, word_to);
+
+    if (word != 0) {
+      return word_idx * 64 + static_cast<uint64_t>(std::countr_zero(word)) -
+             from;
+    }
+  }
+
+  return view.size();
+}
+
+bool Contains(const BitView view, const bool value) {
+  return Find(view, value) != view.size();
+}
+
+uint64_t Count(const Vector<bool>& vector, const bool value) {
+  return Count(vector.subview(0, vector.size()), value);
+}
+
+uint64_t Find(const Vector<bool>& vector, const bool value) {
+  return Find(vector.subview(0, vector.size()), value);
+}
+
+bool Contains(const Vector<bool>& vector, const bool value) {
+  return Contains(vector.subview(0, vector.size()), value);
+}
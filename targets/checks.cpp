@@ -0,0 +1,494 @@
+#include "../include/main.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Behavioral checks for the containers and pools, they abort on the first
+// failed assert. Build with make checks and run checks.out.
+
+static void CheckPoolTrim() {
+  PagePool<uint64_t> page_pool;
+  std::vector<uint64_t*> elements;
+
+  for (uint64_t idx = 0; idx < 5000; idx++) {
+    elements.push_back(page_pool.Allocate(1));
+  }
+
+  uint64_t reserved_bytes = page_pool.GetReservedBytes();
+
+  for (uint64_t* element : elements) {
+    page_pool.Deallocate(element, 1);
+  }
+
+  page_pool.Trim(0);
+
+  assert(page_pool.GetStats().entries_amount_ == 1);
+  assert(page_pool.GetReservedBytes() < reserved_bytes);
+
+  page_pool.SetHighWatermark(2 * page_pool.GetReservedBytes());
+
+  for (uint64_t idx = 0; idx < 5000; idx++) {
+    elements[idx] = page_pool.Allocate(1);
+  }
+
+  assert(page_pool.GetReservedBytes() == reserved_bytes);
+
+  for (uint64_t* element : elements) {
+    page_pool.Deallocate(element, 1);
+  }
+
+  assert(page_pool.GetStats().entries_amount_ <= 2);
+
+  StackPool<int> stack_pool;
+  std::vector<int*> blocks;
+
+  for (uint64_t idx = 0; idx < 50; idx++) {
+    blocks.push_back(stack_pool.Allocate(1000));
+  }
+
+  assert(stack_pool.GetStats().entries_amount_ > 2);
+
+  for (uint64_t idx = blocks.size(); idx > 0; idx--) {
+    stack_pool.Deallocate(blocks[idx - 1], 1000);
+  }
+
+  stack_pool.Trim(0);
+
+  assert(stack_pool.GetStats().entries_amount_ == 2);
+}
+
+static void CheckStackPadding() {
+  StackArena arena;
+
+  char* block = arena.Allocate(3, 1);
+  StackArena::Checkpoint checkpoint = arena.Mark();
+
+  char* aligned = arena.Allocate(5, 64);
+  char* nested = arena.Allocate(7, 32);
+
+  assert((reinterpret_cast<uint64_t>(aligned) % 64) == 0);
+  assert((reinterpret_cast<uint64_t>(nested) % 32) == 0);
+
+  arena.Deallocate(nested, 7, 32);
+  arena.Deallocate(aligned, 5, 64);
+
+  assert(arena.Mark().ptr_ == checkpoint.ptr_);
+
+  char* back_block = arena.AllocateBack(3, 1);
+  StackArena::Checkpoint back_checkpoint = arena.MarkBack();
+
+  char* back_aligned = arena.AllocateBack(5, 128);
+
+  assert((reinterpret_cast<uint64_t>(back_aligned) % 128) == 0);
+
+  arena.DeallocateBack(back_aligned, 5, 128);
+
+  assert(arena.MarkBack().ptr_ == back_checkpoint.ptr_);
+
+  arena.DeallocateBack(back_block, 3, 1);
+  arena.Deallocate(block, 3, 1);
+}
+
+template <typename T>
+static void CheckSimdKernels(const T step) {
+  Vector<T> vector;
+
+  for (uint64_t idx = 0; idx < 100; idx++) {
+    vector.push_back(static_cast<T>(static_cast<T>((idx * 37) % 23) * step));
+  }
+
+  // Every head offset and tail length, so the scalar edges of the kernels
+  // and the non-SIMD fallbacks both see all of them.
+  for (uint64_t offset = 0; offset < 4; offset++) {
+    for (uint64_t size = 0; size + offset <= vector.size(); size++) {
+      VectorView<T> view = vector.subview(offset, size);
+      const T* first = view.data();
+      const T* last = first + size;
+
+      for (T value : {T(), static_cast<T>(5 * step), static_cast<T>(99)}) {
+        assert(Find(view, value) ==
+               static_cast<uint64_t>(std::find(first, last, value) - first));
+        assert(Count(view, value) ==
+               static_cast<uint64_t>(std::count(first, last, value)));
+      }
+
+      if (size == 0) {
+        assert(MinElement(view) == 0);
+        assert(MaxElement(view) == 0);
+
+        continue;
+      }
+
+      assert(MinElement(view) ==
+             static_cast<uint64_t>(std::min_element(first, last) - first));
+      assert(MaxElement(view) ==
+             static_cast<uint64_t>(std::max_element(first, last) - first));
+
+      // The values are small integers or halves, so even lane-wise float
+      // sums are exact.
+      T sum = Sum(view);
+      T expected_sum = std::accumulate(first, last, T());
+
+      assert(!(sum < expected_sum) && !(expected_sum < sum));
+    }
+  }
+}
+
+static void CheckSimdFallbacks() {
+  CheckSimdKernels<int32_t>(-3);
+  CheckSimdKernels<uint32_t>(3);
+  CheckSimdKernels<int64_t>(-3);
+  CheckSimdKernels<uint64_t>(3);
+  CheckSimdKernels<float>(0.5f);
+  CheckSimdKernels<double>(-0.5);
+  CheckSimdKernels<int16_t>(3);
+
+  // Lane counters are flushed before they wrap.
+  Vector<uint32_t> equal(0x30000, 7);
+  assert(Count(equal, 7u) == 0x30000);
+
+  Vector<double> with_nan(40, 1.0);
+  with_nan[17] = std::nan("");
+  assert(Find(with_nan, with_nan[17]) == with_nan.size());
+  assert(Count(with_nan, 1.0) == 39);
+
+  Vector<bool> bits(130, false);
+  bits[129] = true;
+  bits[64] = true;
+  assert(Count(bits, true) == 2);
+  assert(Find(bits, true) == 64);
+  assert(!Contains(Vector<bool>(70, false), true));
+}
+
+static void CheckRadixFloatKeys() {
+  struct Entry {
+    double key_;
+    uint64_t idx_;
+  };
+
+  const double keys[] = {-0.0,
+                         0.0,
+                         1.5,
+                         -2.0,
+                         std::numeric_limits<double>::quiet_NaN(),
+                         std::numeric_limits<double>::infinity(),
+                         -std::numeric_limits<double>::infinity()};
+
+  // Below and above RadixSmallSortSize, which take different paths.
+  for (uint64_t size : {RadixSmallSortSize / 2, RadixSmallSortSize * 4}) {
+    Vector<Entry> entries;
+
+    for (uint64_t idx = 0; idx < size; idx++) {
+      entries.push_back({keys[(idx * 5) % std::size(keys)], idx});
+    }
+
+    RadixSort(entries, [](const Entry& entry) { return entry.key_; });
+
+    // Positive NaNs order after +inf, and -0.0 ties with +0.0, so ties of
+    // both kinds keep their input order.
+    for (uint64_t idx = 1; idx < size; idx++) {
+      const Entry& prev = entries[idx - 1];
+      const Entry& cur = entries[idx];
+
+      if (std::isnan(prev.key_)) {
+        assert(std::isnan(cur.key_) && (prev.idx_ < cur.idx_));
+      } else if (!std::isnan(cur.key_)) {
+        assert(!(cur.key_ < prev.key_));
+        assert((prev.key_ < cur.key_) || (prev.idx_ < cur.idx_));
+      }
+    }
+
+    assert(std::isnan(entries.back().key_));
+  }
+}
+
+static void CheckRingBuffer() {
+  RingBuffer<uint64_t> fixed(6);
+  uint64_t element = 0;
+
+  assert(fixed.capacity() == 8);
+
+  for (uint64_t value = 0; value < 5; value++) {
+    assert(fixed.push(value));
+  }
+
+  for (uint64_t value = 0; value < 3; value++) {
+    assert(fixed.pop(element) && (element == value));
+  }
+
+  // The bulk push wraps around the end of the storage.
+  uint64_t pushed[] = {5, 6, 7, 8, 9, 10, 11};
+  assert(fixed.push(std::span<const uint64_t>(pushed)) == 6);
+  assert(fixed.full() && !fixed.push(12));
+
+  for (uint64_t idx = 0; idx < fixed.size(); idx++) {
+    assert(fixed[idx] == idx + 3);
+  }
+
+  uint64_t popped[10] = {};
+  assert(fixed.pop(std::span<uint64_t>(popped)) == 8);
+  assert(fixed.empty() && !fixed.pop(element));
+
+  for (uint64_t idx = 0; idx < 8; idx++) {
+    assert(popped[idx] == idx + 3);
+  }
+
+  // Growing a wrapped buffer keeps the order.
+  RingBuffer<uint64_t> growable(4, true);
+
+  for (uint64_t value = 0; value < 3; value++) {
+    growable.push(value);
+  }
+
+  growable.pop(element);
+  growable.pop(element);
+
+  for (uint64_t value = 3; value < 40; value++) {
+    assert(growable.push(value));
+  }
+
+  assert((growable.size() == 38) && (growable.capacity() == 64));
+  assert((growable.front() == 2) && (growable.back() == 39));
+
+  for (uint64_t value = 2; value < 40; value++) {
+    assert(growable.pop(element) && (element == value));
+  }
+
+  SpscRingBuffer<uint64_t> spsc(16);
+  const uint64_t values_amount = 100000;
+
+  std::thread producer([&spsc, values_amount] {
+    for (uint64_t value = 0; value < values_amount; value++) {
+      while (!spsc.try_push(value)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (uint64_t value = 0; value < values_amount; value++) {
+    while (!spsc.try_pop(element)) {
+      std::this_thread::yield();
+    }
+
+    assert(element == value);
+  }
+
+  producer.join();
+  assert(spsc.empty());
+}
+
+template <template <typename> class Memory>
+static void CheckStringVector() {
+  BasicStringVector<Memory> strings;
+  std::vector<std::string> expected;
+
+  strings.push_back("packed");
+  expected.push_back("packed");
+
+  // Every push reads a string out of the buffer it may reallocate.
+  for (uint64_t idx = 0; idx < 40; idx++) {
+    strings.push_back(strings[idx / 2]);
+    expected.push_back(expected[idx / 2]);
+  }
+
+  uint64_t sizes[] = {3, 3};
+  strings.append(std::string_view(strings.bytes(), 6), std::span(sizes));
+  expected.push_back("pac");
+  expected.push_back("ked");
+
+  strings.append("x,yy,packed,", ',');
+  expected.push_back("x");
+  expected.push_back("yy");
+  expected.push_back("packed");
+
+  assert(strings.size() == expected.size());
+
+  for (uint64_t idx = 0; idx < expected.size(); idx++) {
+    assert(strings[idx] == expected[idx]);
+  }
+
+  strings.sort();
+  strings.unique();
+  strings.compact();
+
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()),
+                 expected.end());
+
+  assert(strings.size() == expected.size());
+
+  uint64_t live_size = 0;
+
+  for (uint64_t idx = 0; idx < expected.size(); idx++) {
+    assert(strings[idx] == expected[idx]);
+    live_size += expected[idx].size();
+  }
+
+  assert(strings.bytes_size() == live_size);
+}
+
+template <typename T, typename Model>
+static void AssertSameElements(const Vector<T>& vector, const Model& model) {
+  assert(vector.size() == std::size(model));
+
+  for (uint64_t idx = 0; idx < std::size(model); idx++) {
+    assert(vector[idx] == model[idx]);
+  }
+}
+
+static void CheckInsertAliasing() {
+  Vector<std::string> strings;
+  std::vector<std::string> model;
+
+  for (uint64_t idx = 0; idx < 8; idx++) {
+    strings.push_back(std::string(20, static_cast<char>('a' + idx)));
+    model.push_back(std::string(20, static_cast<char>('a' + idx)));
+  }
+
+  // Sources inside the vector, both with and without a reallocation.
+  strings.append_range(std::span(strings.data(), strings.size()));
+  std::vector<std::string> source(model);
+  model.insert(model.end(), source.begin(), source.end());
+  AssertSameElements(strings, model);
+
+  strings.reserve(strings.size() + 16);
+
+  strings.insert(2, strings.data() + 1, strings.data() + 4);
+  source.assign(model.begin() + 1, model.begin() + 4);
+  model.insert(model.begin() + 2, source.begin(), source.end());
+  AssertSameElements(strings, model);
+
+  strings.insert(0, strings[5]);
+  model.insert(model.begin(), std::string(model[5]));
+  strings.insert(3, 4, strings[10]);
+  model.insert(model.begin() + 3, 4, std::string(model[10]));
+  AssertSameElements(strings, model);
+
+  strings.erase(1, 6);
+  model.erase(model.begin() + 1, model.begin() + 7);
+  strings.erase(strings.size() - 1);
+  model.pop_back();
+  AssertSameElements(strings, model);
+
+  Vector<int> ints;
+
+  for (int value = 0; value < 8; value++) {
+    ints.emplace_back(value);
+  }
+
+  ints.insert(3, ints.begin(), ints.end());
+
+  const int expected[] = {0, 1, 2, 0, 1, 2, 3, 4, 5, 6, 7, 3, 4, 5, 6, 7};
+  AssertSameElements(ints, expected);
+}
+
+static void AssertRecords(FileLoader& loader,
+                          const std::vector<std::string>& expected) {
+  std::span<const char> record;
+
+  for (const std::string& expected_record : expected) {
+    assert(loader.NextRecord('\n', record));
+    assert(std::string_view(record.data(), record.size()) == expected_record);
+  }
+
+  assert(!loader.NextRecord('\n', record));
+  assert(!loader.IsFailed());
+}
+
+static void CheckFileLoader() {
+  const uint64_t chunk_size = 0x1000;
+  std::string bytes;
+  std::vector<std::string> expected;
+
+  // Records of every length up to a few chunks, so plenty of them cross a
+  // chunk border and some span several chunks.
+  for (uint64_t idx = 0; idx < 3000; idx++) {
+    uint64_t size = (idx % 100 == 99) ? 3 * chunk_size : (idx * 7) % 61;
+
+    expected.push_back(std::string(size, static_cast<char>('a' + idx % 26)));
+    bytes += expected.back();
+    bytes += '\n';
+  }
+
+  expected.push_back("tail");
+  bytes += "tail";
+
+  FILE* file = std::tmpfile();
+  int fd = fileno(file);
+
+  assert(write(fd, bytes.data(), bytes.size()) ==
+         static_cast<ssize_t>(bytes.size()));
+
+  {
+    lseek(fd, 0, SEEK_SET);
+    FileLoader loader(fd, chunk_size);
+
+    assert(loader.IsMapped());
+    AssertRecords(loader, expected);
+  }
+
+  {
+    int pipe_fds[2];
+    assert(pipe(pipe_fds) == 0);
+
+    std::thread writer([&bytes, &pipe_fds] {
+      for (uint64_t offset = 0; offset < bytes.size();) {
+        ssize_t written =
+            write(pipe_fds[1], bytes.data() + offset,
+                  std::min<uint64_t>(bytes.size() - offset, 1000));
+
+        assert(written > 0);
+        offset += static_cast<uint64_t>(written);
+      }
+
+      close(pipe_fds[1]);
+    });
+
+    {
+      FileLoader loader(pipe_fds[0], chunk_size);
+
+      assert(!loader.IsMapped());
+      AssertRecords(loader, expected);
+    }
+
+    writer.join();
+    close(pipe_fds[0]);
+  }
+
+  // A partial element at the end is left for the next read.
+  Vector<uint32_t> elements;
+
+  lseek(fd, 0, SEEK_SET);
+  assert(elements.append_from_fd(fd, bytes.size()));
+  assert(elements.size() == bytes.size() / sizeof(uint32_t));
+  assert(static_cast<uint64_t>(lseek(fd, 0, SEEK_CUR)) ==
+         elements.size() * sizeof(uint32_t));
+  assert(std::memcmp(elements.data(), bytes.data(),
+                     elements.size() * sizeof(uint32_t)) == 0);
+
+  std::fclose(file);
+}
+
+int main() {
+  CheckPoolTrim();
+  CheckStackPadding();
+  CheckSimdFallbacks();
+  CheckRadixFloatKeys();
+  CheckRingBuffer();
+  CheckStringVector<DefaultMemory>();
+  CheckStringVector<StackMemory>();
+  CheckInsertAliasing();
+  CheckFileLoader();
+
+  std::cout << "checks passed" << std::endl;
+}
@@ -36,5 +36,17 @@ int main() {
   std::cout << std::find(vect.begin(), vect.end(), 1) - vect.begin()
             << std::endl;
 
+  StringVector strings;
+
+  strings.push_back("packed");
+  for (uint64_t idx = 0; idx < 10; idx++) {
+    strings.push_back(strings[idx]);
+  }
+
+  for (std::string_view string : strings) {
+    std::cout << string << ' ';
+  }
+  std::cout << std::endl;
+
   std::cout << std::endl;
 }